@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "archivelisting.h"
+
+#include <QtEndian>
+
+#include <cstring>
+
+std::optional<QStringList> ArchiveListing::files(const QString& path,
+                                                 const QString& directory)
+{
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly)) {
+    return {};
+  }
+
+  QString prefix = QString(directory).replace('\\', '/').toLower();
+  while (prefix.endsWith('/')) {
+    prefix.chop(1);
+  }
+
+  const QByteArray magic = file.peek(4);
+  if (magic == QByteArray("BSA\0", 4)) {
+    return bsaFiles(file, prefix);
+  } else if (magic == "BTDX") {
+    return ba2Files(file, prefix);
+  }
+
+  return {};
+}
+
+std::optional<QStringList> ArchiveListing::bsaFiles(QFile& file,
+                                                    const QString& directory)
+{
+  static constexpr qint64 HEADER_SIZE      = 36;
+  static constexpr qint64 FILE_RECORD_SIZE = 16;
+
+  // names are only stored when both flags are set, which is the case for every
+  // archive the games load
+  static constexpr quint32 DIRECTORY_NAMES = 0x1;
+  static constexpr quint32 FILE_NAMES      = 0x2;
+
+  const QByteArray header = file.read(HEADER_SIZE);
+  if (header.size() != HEADER_SIZE) {
+    return {};
+  }
+
+  const uchar* fields          = reinterpret_cast<const uchar*>(header.constData());
+  const quint32 version        = qFromLittleEndian<quint32>(fields + 4);
+  const quint32 flags          = qFromLittleEndian<quint32>(fields + 12);
+  const qint64 folderCount     = qFromLittleEndian<quint32>(fields + 16);
+  const qint64 fileCount       = qFromLittleEndian<quint32>(fields + 20);
+  const qint64 folderNamesSize = qFromLittleEndian<quint32>(fields + 24);
+  const qint64 fileNamesSize   = qFromLittleEndian<quint32>(fields + 28);
+  if ((flags & DIRECTORY_NAMES) == 0 || (flags & FILE_NAMES) == 0) {
+    return {};
+  }
+
+  // Skyrim Special Edition widened the offsets of the folder records
+  const qint64 folderRecordSize = version >= 105 ? 24 : 16;
+
+  // the folder records are followed by one block per folder holding its name, with
+  // a length prefix, and the records of its files; the names of all the files come
+  // last, in the same order
+  const qint64 blocksOffset = HEADER_SIZE + folderCount * folderRecordSize;
+  const qint64 namesOffset =
+      blocksOffset + folderCount + folderNamesSize + fileCount * FILE_RECORD_SIZE;
+  const qint64 end = namesOffset + fileNamesSize;
+
+  QByteArray buffer;
+  const uchar* data = map(file, 0, end, buffer);
+  if (data == nullptr) {
+    return {};
+  }
+
+  QStringList files;
+  qint64 block = blocksOffset;
+  qint64 name  = namesOffset;
+  for (qint64 folder = 0; folder < folderCount; ++folder) {
+    const qint64 count =
+        qFromLittleEndian<quint32>(data + HEADER_SIZE + folder * folderRecordSize + 8);
+    if (block >= namesOffset) {
+      return {};
+    }
+
+    // the length includes the terminating zero
+    const qint64 nameSize = data[block];
+    if (block + 1 + nameSize + count * FILE_RECORD_SIZE > namesOffset) {
+      return {};
+    }
+    const char* folderName = reinterpret_cast<const char*>(data + block + 1);
+    const QString path     = normalize(folderName, qstrnlen(folderName, nameSize));
+    block += 1 + nameSize + count * FILE_RECORD_SIZE;
+
+    // the names of the other folders still have to be skipped
+    const bool wanted = isBelow(path, directory);
+    for (qint64 i = 0; i < count; ++i) {
+      if (name >= end) {
+        return {};
+      }
+
+      const char* fileName = reinterpret_cast<const char*>(data + name);
+      const qsizetype size = qstrnlen(fileName, end - name);
+      if (wanted) {
+        const QString file = normalize(fileName, size);
+        files.append(path.isEmpty() ? file : path + "/" + file);
+      }
+      name += size + 1;
+    }
+  }
+
+  return files;
+}
+
+std::optional<QStringList> ArchiveListing::ba2Files(QFile& file,
+                                                    const QString& directory)
+{
+  static constexpr qint64 HEADER_SIZE = 24;
+
+  const QByteArray header = file.read(HEADER_SIZE);
+  if (header.size() != HEADER_SIZE) {
+    return {};
+  }
+
+  // the name table is at the end of the archive, after the content of the files
+  const uchar* fields     = reinterpret_cast<const uchar*>(header.constData());
+  const qint64 fileCount  = qFromLittleEndian<quint32>(fields + 12);
+  const quint64 namesFrom = qFromLittleEndian<quint64>(fields + 16);
+  if (namesFrom < HEADER_SIZE || namesFrom >= static_cast<quint64>(file.size())) {
+    return {};
+  }
+
+  const qint64 offset = static_cast<qint64>(namesFrom);
+  const qint64 length = file.size() - offset;
+
+  QByteArray buffer;
+  const uchar* data = map(file, offset, length, buffer);
+  if (data == nullptr) {
+    return {};
+  }
+
+  // every name is prefixed by its length and is not terminated
+  QStringList files;
+  qint64 position = 0;
+  for (qint64 i = 0; i < fileCount; ++i) {
+    if (position + 2 > length) {
+      return {};
+    }
+    const qint64 size = qFromLittleEndian<quint16>(data + position);
+    position += 2;
+    if (position + size > length) {
+      return {};
+    }
+
+    const char* name   = reinterpret_cast<const char*>(data + position);
+    const QString path = normalize(name, size);
+    if (isBelow(path, directory)) {
+      files.append(path);
+    }
+    position += size;
+  }
+
+  return files;
+}
+
+const uchar* ArchiveListing::map(QFile& file, qint64 offset, qint64 length,
+                                 QByteArray& buffer)
+{
+  if (offset < 0 || length <= 0 || offset + length > file.size()) {
+    return nullptr;
+  }
+
+  // the mapping is released when the file is closed
+  if (const uchar* data = file.map(offset, length)) {
+    return data;
+  }
+
+  // mapping may fail on some file systems, the range is read in that case
+  if (!file.seek(offset)) {
+    return nullptr;
+  }
+  buffer = file.read(length);
+  if (buffer.size() != length) {
+    return nullptr;
+  }
+  return reinterpret_cast<const uchar*>(buffer.constData());
+}
+
+QString ArchiveListing::normalize(const char* name, qsizetype length)
+{
+  // names use the Windows code page
+  return QString::fromLatin1(name, length).replace('\\', '/').toLower();
+}
+
+bool ArchiveListing::isBelow(const QString& path, const QString& directory)
+{
+  if (directory.isEmpty()) {
+    return true;
+  }
+
+  return path.startsWith(directory) &&
+         (path.size() == directory.size() || path.at(directory.size()) == '/');
+}
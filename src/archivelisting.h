@@ -0,0 +1,60 @@
+/*
+Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+
+This file is part of basic diagnosis plugin for MO
+
+This plugin is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This plugin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ARCHIVELISTING_H
+#define ARCHIVELISTING_H
+
+#include <QFile>
+#include <QString>
+#include <QStringList>
+
+#include <optional>
+
+// lists the files packed in a Bethesda archive, bsa or ba2, from its directory
+//
+// only the header and the name tables are mapped, the content of the files is never
+// read, so listing a large archive costs about as much as listing a small one
+class ArchiveListing
+{
+public:
+  // paths of the files below the given directory of the archive, lowercase and with
+  // forward slashes; nothing if the file cannot be read or is not a supported archive
+  static std::optional<QStringList> files(const QString& path,
+                                          const QString& directory);
+
+private:
+  // Oblivion up to Skyrim Special Edition
+  static std::optional<QStringList> bsaFiles(QFile& file, const QString& directory);
+
+  // Fallout 4 and later
+  static std::optional<QStringList> ba2Files(QFile& file, const QString& directory);
+
+  // maps the given range of the file, the range is read into the buffer when it
+  // cannot be mapped
+  static const uchar* map(QFile& file, qint64 offset, qint64 length,
+                          QByteArray& buffer);
+
+  // lowercase path with forward slashes
+  static QString normalize(const char* name, qsizetype length);
+
+  // true if the given normalized path is the directory or below it
+  static bool isBelow(const QString& path, const QString& directory);
+};
+
+#endif  // ARCHIVELISTING_H
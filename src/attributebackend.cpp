@@ -0,0 +1,304 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "attributebackend.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+
+#include <cerrno>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+#ifdef _WIN32
+
+// converts a FILETIME to milliseconds since the epoch
+static std::int64_t toMSecs(const FILETIME& time)
+{
+  ULARGE_INTEGER value;
+  value.LowPart  = time.dwLowDateTime;
+  value.HighPart = time.dwHighDateTime;
+
+  // FILETIME counts 100ns intervals since 1601-01-01
+  return static_cast<std::int64_t>(value.QuadPart / 10000) - 11644473600000;
+}
+
+static bool isWalkable(DWORD attrs)
+{
+  // links are not followed so that cycles cannot keep the walk going
+  return (attrs & FILE_ATTRIBUTE_DIRECTORY) && !(attrs & FILE_ATTRIBUTE_REPARSE_POINT);
+}
+
+class WindowsAttributeHandle : public AttributeHandle
+{
+public:
+  explicit WindowsAttributeHandle(HANDLE handle) : m_Handle(handle) {}
+  ~WindowsAttributeHandle() { CloseHandle(m_Handle); }
+
+  std::uint32_t setCompressed(bool compressed) override
+  {
+    USHORT setting = compressed ? COMPRESSION_FORMAT_DEFAULT : COMPRESSION_FORMAT_NONE;
+
+    DWORD bytesReturned = 0;
+    if (!DeviceIoControl(m_Handle, FSCTL_SET_COMPRESSION, &setting, sizeof(setting),
+                         NULL, 0, &bytesReturned, NULL)) {
+      return GetLastError();
+    }
+    return 0;
+  }
+
+  std::uint32_t setSparse(bool sparse) override
+  {
+    FILE_SET_SPARSE_BUFFER setting = {sparse ? TRUE : FALSE};
+    DWORD bytesReturned            = 0;
+    if (!DeviceIoControl(m_Handle, FSCTL_SET_SPARSE, &setting, sizeof(setting), NULL, 0,
+                         &bytesReturned, NULL)) {
+      return GetLastError();
+    }
+    return 0;
+  }
+
+private:
+  HANDLE m_Handle;
+};
+
+class WindowsAttributeBackend : public AttributeBackend
+{
+public:
+  QString nativePath(const QString& path) const override
+  {
+    // the prefix lifts the MAX_PATH limit
+    return QString("\\\\?\\%1").arg(QDir::toNativeSeparators(path));
+  }
+
+  bool list(const QString& directory,
+            std::vector<AttributeEntry>& entries) const override
+  {
+    const std::wstring pattern = (directory + "\\*").toStdWString();
+
+    WIN32_FIND_DATAW data;
+    HANDLE handle =
+        FindFirstFileExW(pattern.c_str(), FindExInfoBasic, &data, FindExSearchNameMatch,
+                         NULL, FIND_FIRST_EX_LARGE_FETCH);
+    if (handle == INVALID_HANDLE_VALUE) {
+      DWORD error = GetLastError();
+      if (error != ERROR_FILE_NOT_FOUND) {
+        qWarning(qUtf8Printable(QString("Unable to list directory %1 (error %2)")
+                                    .arg(directory)
+                                    .arg(error)));
+      }
+      return false;
+    }
+
+    do {
+      const std::wstring_view name(data.cFileName);
+      if (name == L"." || name == L"..") {
+        continue;
+      }
+
+      entries.push_back(
+          AttributeEntry{directory + "\\" + QString::fromWCharArray(data.cFileName),
+                         data.dwFileAttributes, toMSecs(data.ftLastWriteTime),
+                         isWalkable(data.dwFileAttributes)});
+    } while (FindNextFileW(handle, &data));
+
+    FindClose(handle);
+    return true;
+  }
+
+  std::optional<AttributeEntry> probe(const QString& path) const override
+  {
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExW(path.toStdWString().c_str(), GetFileExInfoStandard,
+                              &data)) {
+      DWORD error = ::GetLastError();
+      qWarning(qUtf8Printable(QString("Unable to get file attributes for %1 (error %2)")
+                                  .arg(path)
+                                  .arg(error)));
+      return {};
+    }
+    return AttributeEntry{path, data.dwFileAttributes, toMSecs(data.ftLastWriteTime),
+                          isWalkable(data.dwFileAttributes)};
+  }
+
+  bool isProblematic(std::uint32_t attrs) const override
+  {
+    return !(attrs & FILE_ATTRIBUTE_ARCHIVE) && !(attrs & FILE_ATTRIBUTE_NORMAL) &&
+           (attrs & ~(FILE_ATTRIBUTE_DIRECTORY | FILE_ATTRIBUTE_ARCHIVE));
+  }
+
+  QString describe(std::uint32_t attrs, const QString& path) const override
+  {
+    QString debug;
+    debug += QString("%1 ").arg(attrs, 8, 16, QLatin1Char('0'));
+
+    // A C D H I O P R S U V X Z
+    debug += (attrs & FILE_ATTRIBUTE_DIRECTORY) ? "D" : " ";
+    debug += (attrs & FILE_ATTRIBUTE_ARCHIVE) ? "A" : " ";
+    debug += (attrs & FILE_ATTRIBUTE_READONLY) ? "R" : " ";
+    debug += (attrs & FILE_ATTRIBUTE_SYSTEM) ? "S" : " ";
+    debug += (attrs & FILE_ATTRIBUTE_HIDDEN) ? "H" : " ";
+    debug += (attrs & FILE_ATTRIBUTE_OFFLINE) ? "O" : " ";
+    debug += (attrs & FILE_ATTRIBUTE_NOT_CONTENT_INDEXED) ? "I" : " ";
+    debug += (attrs & FILE_ATTRIBUTE_NO_SCRUB_DATA) ? "X" : " ";
+    debug += (attrs & FILE_ATTRIBUTE_INTEGRITY_STREAM) ? "V" : " ";
+    debug += (attrs & FILE_ATTRIBUTE_PINNED) ? "P" : " ";
+    debug += (attrs & FILE_ATTRIBUTE_UNPINNED) ? "U" : " ";
+    debug += (attrs & FILE_ATTRIBUTE_COMPRESSED) ? "C" : " ";
+    debug += (attrs & FILE_ATTRIBUTE_SPARSE_FILE) ? "Z" : " ";
+
+    debug += QString(" %1").arg(path);
+    return debug;
+  }
+
+  AttributeRepair planRepair(std::uint32_t attrs) const override
+  {
+    // clear all the attributes possible, except ARCHIVE, compression and sparseness
+    // require DeviceIoControl
+    return AttributeRepair{attrs & FILE_ATTRIBUTE_ARCHIVE ? FILE_ATTRIBUTE_ARCHIVE : 0,
+                           (attrs & FILE_ATTRIBUTE_COMPRESSED) != 0,
+                           (attrs & FILE_ATTRIBUTE_SPARSE_FILE) != 0};
+  }
+
+  std::uint32_t withArchive(std::uint32_t attrs) const override
+  {
+    return attrs | FILE_ATTRIBUTE_ARCHIVE;
+  }
+
+  std::uint32_t setAttributes(const QString& path, std::uint32_t attrs) const override
+  {
+    if (!SetFileAttributesW(path.toStdWString().c_str(), attrs)) {
+      return GetLastError();
+    }
+    return 0;
+  }
+
+  std::unique_ptr<AttributeHandle> open(const QString& path,
+                                        std::uint32_t& error) const override
+  {
+    // backup semantics are needed to open directories
+    HANDLE handle =
+        CreateFileW(path.toStdWString().c_str(), GENERIC_READ | GENERIC_WRITE,
+                    FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING,
+                    FILE_ATTRIBUTE_NORMAL | FILE_FLAG_BACKUP_SEMANTICS, NULL);
+    if (handle == INVALID_HANDLE_VALUE) {
+      error = GetLastError();
+      return nullptr;
+    }
+    return std::make_unique<WindowsAttributeHandle>(handle);
+  }
+};
+
+#endif
+
+// accepts every change without touching the file
+class StubAttributeHandle : public AttributeHandle
+{
+public:
+  std::uint32_t setCompressed(bool) override { return 0; }
+  std::uint32_t setSparse(bool) override { return 0; }
+};
+
+// lists directories portably, attributes are always reported as clean and changes
+// are accepted without touching the files
+class StubAttributeBackend : public AttributeBackend
+{
+public:
+  QString nativePath(const QString& path) const override
+  {
+    return QDir::cleanPath(path);
+  }
+
+  bool list(const QString& directory,
+            std::vector<AttributeEntry>& entries) const override
+  {
+    QDir dir(directory);
+    if (!dir.exists()) {
+      return false;
+    }
+
+    for (const QFileInfo& entry : dir.entryInfoList(
+             QDir::Hidden | QDir::System | QDir::AllEntries | QDir::NoDotAndDotDot)) {
+      entries.push_back(toEntry(entry));
+    }
+    return true;
+  }
+
+  std::optional<AttributeEntry> probe(const QString& path) const override
+  {
+    QFileInfo info(path);
+    if (!info.exists()) {
+      return {};
+    }
+    return toEntry(info);
+  }
+
+  bool isProblematic(std::uint32_t) const override { return false; }
+
+  QString describe(std::uint32_t attributes, const QString& path) const override
+  {
+    return QString("%1 %2").arg(attributes, 8, 16, QLatin1Char('0')).arg(path);
+  }
+
+  AttributeRepair planRepair(std::uint32_t attributes) const override
+  {
+    return AttributeRepair{attributes, false, false};
+  }
+
+  std::uint32_t withArchive(std::uint32_t attributes) const override
+  {
+    return attributes;
+  }
+
+  std::uint32_t setAttributes(const QString&, std::uint32_t) const override
+  {
+    return 0;
+  }
+
+  std::unique_ptr<AttributeHandle> open(const QString& path,
+                                        std::uint32_t& error) const override
+  {
+    if (!QFileInfo::exists(path)) {
+      error = ENOENT;
+      return nullptr;
+    }
+    return std::make_unique<StubAttributeHandle>();
+  }
+
+private:
+  static AttributeEntry toEntry(const QFileInfo& info)
+  {
+    return AttributeEntry{info.absoluteFilePath(), 0,
+                          info.lastModified().toMSecsSinceEpoch(),
+                          info.isDir() && !info.isSymLink()};
+  }
+};
+
+std::unique_ptr<AttributeBackend> AttributeBackend::create()
+{
+#ifdef _WIN32
+  return std::make_unique<WindowsAttributeBackend>();
+#else
+  return std::make_unique<StubAttributeBackend>();
+#endif
+}
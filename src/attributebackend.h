@@ -0,0 +1,114 @@
+/*
+Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+
+This file is part of basic diagnosis plugin for MO
+
+This plugin is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This plugin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ATTRIBUTEBACKEND_H
+#define ATTRIBUTEBACKEND_H
+
+#include <QString>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+// an entry of a directory listing along with its attributes
+struct AttributeEntry
+{
+  QString path;
+  std::uint32_t attributes;
+
+  // last write time in milliseconds since the epoch
+  std::int64_t modified;
+
+  // true for directories that should be walked, links are never followed
+  bool descend;
+};
+
+// changes needed to bring the attributes of an entry back to normal
+struct AttributeRepair
+{
+  // attributes to set directly
+  std::uint32_t attributes;
+
+  // states that can only be changed through an open handle
+  bool decompress;
+  bool unsparse;
+};
+
+// open file or directory whose compression and sparseness can be changed
+//
+// the functions return 0 on success and the system error code otherwise
+class AttributeHandle
+{
+public:
+  virtual ~AttributeHandle() = default;
+
+  virtual std::uint32_t setCompressed(bool compressed) = 0;
+  virtual std::uint32_t setSparse(bool sparse)         = 0;
+};
+
+// platform specific access to file attributes
+//
+// the Windows backend reads the attributes from the directory enumeration, other
+// platforms get a stub that lists directories but never reports attributes, so the
+// scanning logic can run everywhere
+class AttributeBackend
+{
+public:
+  // backend for the current platform
+  static std::unique_ptr<AttributeBackend> create();
+
+  virtual ~AttributeBackend() = default;
+
+  // converts a path to the form expected by the other functions
+  virtual QString nativePath(const QString& path) const = 0;
+
+  // appends the entries of the given directory to the list, returns false if the
+  // directory cannot be listed
+  virtual bool list(const QString& directory,
+                    std::vector<AttributeEntry>& entries) const = 0;
+
+  // entry for a single path, nothing if its attributes cannot be read
+  virtual std::optional<AttributeEntry> probe(const QString& path) const = 0;
+
+  // returns true if the attributes may prevent the game from reading the file
+  virtual bool isProblematic(std::uint32_t attributes) const = 0;
+
+  // human-readable form of the attributes of the given path, for logging
+  virtual QString describe(std::uint32_t attributes, const QString& path) const = 0;
+
+  // changes that clear the problematic attributes, the archive flag is kept
+  virtual AttributeRepair planRepair(std::uint32_t attributes) const = 0;
+
+  // the given attributes with the archive flag set, the last resort when a repair
+  // fails
+  virtual std::uint32_t withArchive(std::uint32_t attributes) const = 0;
+
+  // replaces the attributes of the given path, returns 0 on success and the system
+  // error code otherwise
+  virtual std::uint32_t setAttributes(const QString& path,
+                                      std::uint32_t attributes) const = 0;
+
+  // opens the given path for changing its compression or sparseness, returns null
+  // and sets the error code on failure
+  virtual std::unique_ptr<AttributeHandle> open(const QString& path,
+                                                std::uint32_t& error) const = 0;
+};
+
+#endif  // ATTRIBUTEBACKEND_H
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "attributecache.h"
+
+#include <QDataStream>
+#include <QDebug>
+#include <QFile>
+#include <QSaveFile>
+
+static constexpr quint32 CACHE_MAGIC = 0x4d4f4143;
+
+// bumped whenever the layout below changes, older caches are discarded
+static constexpr quint32 CACHE_VERSION = 2;
+
+bool AttributeCache::load(const QString& path)
+{
+  m_Directories.clear();
+
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly)) {
+    return false;
+  }
+
+  QDataStream stream(&file);
+  stream.setVersion(QDataStream::Qt_6_0);
+
+  quint32 magic = 0, version = 0;
+  quint64 count = 0;
+  stream >> magic >> version >> count;
+  if (magic != CACHE_MAGIC || version != CACHE_VERSION) {
+    return false;
+  }
+
+  // the count is not trusted to size anything, a corrupted file simply runs out of
+  // data before reaching it
+  for (quint64 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+    QString directory;
+    qint64 modified;
+    bool clean;
+    QStringList subdirectories;
+    stream >> directory >> modified >> clean >> subdirectories;
+    m_Directories.insert(directory, {modified, clean, subdirectories});
+  }
+
+  if (stream.status() != QDataStream::Ok) {
+    qWarning() << "Discarding corrupted attribute cache" << path;
+    m_Directories.clear();
+    return false;
+  }
+
+  return true;
+}
+
+bool AttributeCache::save(const QString& path) const
+{
+  QSaveFile file(path);
+  if (!file.open(QIODevice::WriteOnly)) {
+    qWarning() << "Unable to write attribute cache" << path;
+    return false;
+  }
+
+  QDataStream stream(&file);
+  stream.setVersion(QDataStream::Qt_6_0);
+
+  stream << CACHE_MAGIC << CACHE_VERSION << quint64(m_Directories.size());
+  for (auto it = m_Directories.cbegin(); it != m_Directories.cend(); ++it) {
+    stream << it.key() << qint64(it->modified) << it->clean << it->subdirectories;
+  }
+
+  return file.commit();
+}
+
+const AttributeCache::Directory* AttributeCache::find(const QString& path) const
+{
+  auto it = m_Directories.constFind(path);
+  return it == m_Directories.cend() ? nullptr : &*it;
+}
+
+void AttributeCache::insert(const QString& path, Directory directory)
+{
+  m_Directories.insert(path, std::move(directory));
+}
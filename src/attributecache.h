@@ -0,0 +1,66 @@
+/*
+Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+
+This file is part of basic diagnosis plugin for MO
+
+This plugin is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This plugin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ATTRIBUTECACHE_H
+#define ATTRIBUTECACHE_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+#include <cstdint>
+
+// results of the last attribute scan per directory, saved between runs
+//
+// a directory whose last write time has not changed since it was found clean does
+// not need to be listed again, only its subdirectories have to be visited
+class AttributeCache
+{
+public:
+  struct Directory
+  {
+    // last write time of the directory when it was listed
+    std::int64_t modified;
+
+    // true if none of the entries had problematic attributes
+    bool clean;
+
+    // full paths of the subdirectories that are walked
+    QStringList subdirectories;
+  };
+
+  // replaces the content with the cache stored in the given file, returns false and
+  // leaves the cache empty if the file is missing or unreadable
+  bool load(const QString& path);
+
+  // writes the cache to the given file
+  bool save(const QString& path) const;
+
+  // entry for the given directory, or null if it was not scanned
+  const Directory* find(const QString& path) const;
+
+  void insert(const QString& path, Directory directory);
+  void clear() { m_Directories.clear(); }
+  qsizetype size() const { return m_Directories.size(); }
+
+private:
+  QHash<QString, Directory> m_Directories;
+};
+
+#endif  // ATTRIBUTECACHE_H
@@ -0,0 +1,297 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "attributerepairer.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+
+#include <algorithm>
+#include <thread>
+
+namespace
+{
+
+struct StepInfo
+{
+  // name in the log
+  const char* name;
+
+  // action for warnings, "Unable to <action> for <path>"
+  const char* action;
+};
+
+// indexed by AttributeRepairer::Step
+constexpr StepInfo STEPS[] = {{"attributes", "set file attributes"},
+                              {"open", "open file"},
+                              {"compression", "change compression"},
+                              {"sparse", "change sparseness"},
+                              {"archive", "set the archive flag"}};
+
+}  // namespace
+
+AttributeRepairer::AttributeRepairer(const AttributeBackend& backend,
+                                     const QString& logPath)
+    : m_Backend(backend), m_LogPath(logPath)
+{}
+
+QStringList AttributeRepairer::repair(const QStringList& paths)
+{
+  m_Session   = QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs);
+  m_Processed = 0;
+  m_Total     = static_cast<int>(paths.size());
+  openLog();
+
+  std::atomic<qsizetype> next = 0;
+  std::mutex mutex;
+  QStringList failed;
+
+  // workers take chunks from the front until the list is exhausted, so a chunk of
+  // slow files does not hold up the others
+  auto work = [&]() {
+    std::vector<Record> records;
+    QStringList unrepaired;
+    for (;;) {
+      const qsizetype begin = next.fetch_add(CHUNK_SIZE);
+      if (begin >= paths.size()) {
+        break;
+      }
+      const qsizetype end = std::min<qsizetype>(begin + CHUNK_SIZE, paths.size());
+
+      records.clear();
+      for (qsizetype i = begin; i < end; ++i) {
+        if (!repairFile(paths[i], records)) {
+          unrepaired << paths[i];
+        }
+        ++m_Processed;
+      }
+      write(records, false);
+    }
+
+    std::scoped_lock lock(mutex);
+    failed << unrepaired;
+  };
+
+  const qsizetype chunks = (paths.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+  const qsizetype threads =
+      std::min<qsizetype>(std::max(QThread::idealThreadCount(), 1), chunks);
+
+  std::vector<std::thread> pool;
+  for (qsizetype i = 0; i < threads; ++i) {
+    pool.emplace_back(work);
+  }
+  for (auto& thread : pool) {
+    thread.join();
+  }
+
+  failed.sort();
+  return failed;
+}
+
+bool AttributeRepairer::repairFile(const QString& path,
+                                   std::vector<Record>& records) const
+{
+  auto entry = m_Backend.probe(path);
+  if (!entry) {
+    return false;
+  }
+
+  bool success = true;
+  auto attempt = [&](Step step, std::int64_t before, std::int64_t after,
+                     std::uint32_t error) {
+    records.push_back(Record{path, step, before, after, error});
+    if (error != 0) {
+      qWarning(qUtf8Printable(QString("Unable to %1 for %2 (error %3)")
+                                  .arg(STEPS[static_cast<int>(step)].action)
+                                  .arg(path)
+                                  .arg(error)));
+      success = false;
+    }
+  };
+
+  const AttributeRepair plan = m_Backend.planRepair(entry->attributes);
+  attempt(Step::Attributes, entry->attributes, plan.attributes,
+          m_Backend.setAttributes(path, plan.attributes));
+
+  // compression and sparseness share a single handle
+  if (plan.decompress || plan.unsparse) {
+    std::uint32_t error = 0;
+    if (auto handle = m_Backend.open(path, error)) {
+      if (plan.decompress) {
+        attempt(Step::Compression, 1, 0, handle->setCompressed(false));
+      }
+      if (plan.unsparse) {
+        attempt(Step::Sparse, 1, 0, handle->setSparse(false));
+      }
+    } else {
+      attempt(Step::Open, 0, 0, error);
+    }
+  }
+
+  // as a last ditch effort, set the archive flag
+  if (!success) {
+    if (auto current = m_Backend.probe(path)) {
+      const std::uint32_t archived = m_Backend.withArchive(current->attributes);
+      const std::uint32_t error    = m_Backend.setAttributes(path, archived);
+      records.push_back(
+          Record{path, Step::Archive, current->attributes, archived, error});
+      if (error == 0) {
+        success = true;
+      } else {
+        qWarning(
+            qUtf8Printable(QString("Unable to set the archive flag for %1 (error %2)")
+                               .arg(path)
+                               .arg(error)));
+      }
+    }
+  }
+
+  return success;
+}
+
+bool AttributeRepairer::rollback(const QString& session)
+{
+  QFile file(m_LogPath);
+  if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    qWarning() << "Unable to read the attribute repair log" << m_LogPath;
+    return false;
+  }
+
+  std::vector<Record> records;
+  while (!file.atEnd()) {
+    const QJsonObject object = QJsonDocument::fromJson(file.readLine()).object();
+    if (object["session"].toString() != session || object["rollback"].toBool() ||
+        object["error"].toInteger() != 0) {
+      continue;
+    }
+
+    const QString name = object["step"].toString();
+    auto step = std::find_if(std::begin(STEPS), std::end(STEPS), [&](auto& info) {
+      return name == QLatin1String(info.name);
+    });
+    if (step == std::end(STEPS)) {
+      continue;
+    }
+
+    records.push_back(
+        Record{object["path"].toString(), static_cast<Step>(step - std::begin(STEPS)),
+               object["before"].toInteger(), object["after"].toInteger(), 0});
+  }
+  file.close();
+
+  // later changes to a path are undone first
+  bool success = true;
+  std::vector<Record> reverted;
+  for (auto it = records.rbegin(); it != records.rend(); ++it) {
+    const std::uint32_t error = revert(*it);
+    if (error != 0) {
+      qWarning(qUtf8Printable(QString("Unable to revert %1 for %2 (error %3)")
+                                  .arg(STEPS[static_cast<int>(it->step)].name)
+                                  .arg(it->path)
+                                  .arg(error)));
+      success = false;
+    }
+    reverted.push_back(Record{it->path, it->step, it->after, it->before, error});
+  }
+
+  m_Session = session;
+  openLog();
+  write(reverted, true);
+
+  return success;
+}
+
+std::uint32_t AttributeRepairer::revert(const Record& record) const
+{
+  switch (record.step) {
+  case Step::Attributes:
+  case Step::Archive:
+    return m_Backend.setAttributes(record.path,
+                                   static_cast<std::uint32_t>(record.before));
+
+  case Step::Compression:
+  case Step::Sparse: {
+    std::uint32_t error = 0;
+    auto handle         = m_Backend.open(record.path, error);
+    if (!handle) {
+      return error;
+    }
+    return record.step == Step::Compression ? handle->setCompressed(record.before != 0)
+                                            : handle->setSparse(record.before != 0);
+  }
+
+  case Step::Open:
+    break;
+  }
+
+  return 0;
+}
+
+bool AttributeRepairer::openLog()
+{
+  if (m_Log.isOpen()) {
+    return true;
+  }
+
+  QIODevice::OpenMode mode = QIODevice::WriteOnly | QIODevice::Text;
+  mode |= QFileInfo(m_LogPath).size() > MAX_LOG_SIZE ? QIODevice::Truncate
+                                                     : QIODevice::Append;
+
+  m_Log.setFileName(m_LogPath);
+  if (!m_Log.open(mode)) {
+    qWarning() << "Unable to open the attribute repair log" << m_LogPath;
+    return false;
+  }
+  return true;
+}
+
+void AttributeRepairer::write(const std::vector<Record>& records, bool rollback)
+{
+  if (records.empty()) {
+    return;
+  }
+
+  const QString time = QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs);
+
+  QByteArray lines;
+  for (const Record& record : records) {
+    QJsonObject object;
+    object["session"]  = m_Session;
+    object["time"]     = time;
+    object["path"]     = record.path;
+    object["step"]     = STEPS[static_cast<int>(record.step)].name;
+    object["before"]   = static_cast<qint64>(record.before);
+    object["after"]    = static_cast<qint64>(record.after);
+    object["error"]    = static_cast<qint64>(record.error);
+    object["rollback"] = rollback;
+
+    lines += QJsonDocument(object).toJson(QJsonDocument::Compact);
+    lines += '\n';
+  }
+
+  std::scoped_lock lock(m_LogMutex);
+  if (m_Log.isOpen()) {
+    m_Log.write(lines);
+    m_Log.flush();
+  }
+}
@@ -0,0 +1,103 @@
+/*
+Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+
+This file is part of basic diagnosis plugin for MO
+
+This plugin is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This plugin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ATTRIBUTEREPAIRER_H
+#define ATTRIBUTEREPAIRER_H
+
+#include "attributebackend.h"
+
+#include <QFile>
+#include <QString>
+#include <QStringList>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// clears problematic file attributes in parallel and records every change
+//
+// each attempted change is appended to a log file as one JSON object per line, the
+// changes of a repair session can be reverted later from that log
+class AttributeRepairer
+{
+public:
+  AttributeRepairer(const AttributeBackend& backend, const QString& logPath);
+
+  // repairs the given paths in parallel chunks, returns the sorted paths that could
+  // not be repaired
+  QStringList repair(const QStringList& paths);
+
+  // reverts the successful changes recorded for the given session, returns false if
+  // the log cannot be read or a change could not be reverted
+  bool rollback(const QString& session);
+
+  // identifier of the last repair session
+  const QString& session() const { return m_Session; }
+
+  // number of paths processed and to process, for progress reporting
+  const std::atomic<int>& processed() const { return m_Processed; }
+  const std::atomic<int>& total() const { return m_Total; }
+
+private:
+  // logs larger than this are started over instead of appended to
+  static constexpr qint64 MAX_LOG_SIZE = 4 * 1024 * 1024;
+
+  // number of paths a worker takes at once
+  static constexpr int CHUNK_SIZE = 64;
+
+  enum class Step
+  {
+    Attributes,
+    Open,
+    Compression,
+    Sparse,
+    Archive
+  };
+
+  struct Record
+  {
+    QString path;
+    Step step;
+    std::int64_t before;
+    std::int64_t after;
+    std::uint32_t error;
+  };
+
+  bool repairFile(const QString& path, std::vector<Record>& records) const;
+
+  // undoes a single change, returns 0 on success and the system error code otherwise
+  std::uint32_t revert(const Record& record) const;
+
+  // appends the records to the log under the current session
+  bool openLog();
+  void write(const std::vector<Record>& records, bool rollback);
+
+  const AttributeBackend& m_Backend;
+  QString m_LogPath;
+  QString m_Session;
+
+  std::mutex m_LogMutex;
+  QFile m_Log;
+
+  std::atomic<int> m_Processed = 0;
+  std::atomic<int> m_Total     = 0;
+};
+
+#endif  // ATTRIBUTEREPAIRER_H
@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "attributescanner.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QThread>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+AttributeScanner::AttributeScanner(const AttributeBackend& backend) : m_Backend(backend)
+{}
+
+QStringList AttributeScanner::scan(const QStringList& roots, AttributeCache& cache)
+{
+  const std::size_t threads = std::max(QThread::idealThreadCount(), 1);
+
+  m_Workers.clear();
+  for (std::size_t i = 0; i < threads; ++i) {
+    m_Workers.push_back(std::make_unique<Worker>());
+  }
+
+  m_Previous   = &cache;
+  m_Started    = QDateTime::currentMSecsSinceEpoch();
+  m_Pending    = 0;
+  m_Scanned    = 0;
+  m_Discovered = 0;
+  m_Skipped    = 0;
+
+  // the roots are not part of any listing, so they are probed on their own
+  for (int i = 0; i < roots.size(); ++i) {
+    const std::size_t index = static_cast<std::size_t>(i) % threads;
+    if (auto entry = m_Backend.probe(m_Backend.nativePath(roots[i]))) {
+      check(*m_Workers[index], index, *entry);
+    }
+  }
+
+  std::vector<std::thread> pool;
+  for (std::size_t i = 0; i < threads; ++i) {
+    pool.emplace_back(&AttributeScanner::run, this, i);
+  }
+  for (auto& thread : pool) {
+    thread.join();
+  }
+
+  m_Previous = nullptr;
+
+  QStringList result;
+  for (const auto& worker : m_Workers) {
+    result << worker->found;
+  }
+
+  // a partial scan would drop the directories it did not reach
+  if (!m_Canceled) {
+    cache.clear();
+    for (const auto& worker : m_Workers) {
+      for (auto& [path, directory] : worker->visited) {
+        cache.insert(path, std::move(directory));
+      }
+    }
+  }
+
+  m_Workers.clear();
+
+  // the order depends on scheduling, sort so the fixes are applied predictably
+  result.sort();
+  return result;
+}
+
+void AttributeScanner::run(std::size_t index)
+{
+  Worker& worker = *m_Workers[index];
+  std::vector<AttributeEntry> entries;
+  Task task;
+
+  while (!m_Canceled) {
+    if (!next(index, task)) {
+      if (m_Pending == 0) {
+        return;
+      }
+
+      // another worker is still listing a directory that may yield more work
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      continue;
+    }
+
+    visit(worker, index, task, entries);
+
+    // children are pushed before this so the counter cannot reach zero early
+    ++m_Scanned;
+    --m_Pending;
+  }
+}
+
+void AttributeScanner::visit(Worker& worker, std::size_t index, const Task& task,
+                             std::vector<AttributeEntry>& entries)
+{
+  const AttributeCache::Directory* cached = m_Previous->find(task.path);
+  if (cached && cached->clean && cached->modified == task.modified) {
+    // the files are unchanged, but the subdirectories may have been written to
+    for (const QString& subdirectory : cached->subdirectories) {
+      if (auto entry = m_Backend.probe(subdirectory)) {
+        check(worker, index, *entry);
+      }
+    }
+    worker.visited.emplace_back(task.path, *cached);
+    ++m_Skipped;
+    return;
+  }
+
+  entries.clear();
+  if (!m_Backend.list(task.path, entries)) {
+    return;
+  }
+
+  AttributeCache::Directory directory{
+      task.modified, m_Started - task.modified > RACY_INTERVAL, {}};
+  for (const AttributeEntry& entry : entries) {
+    check(worker, index, entry);
+    if (m_Backend.isProblematic(entry.attributes)) {
+      directory.clean = false;
+    }
+    if (entry.descend) {
+      directory.subdirectories << entry.path;
+    }
+  }
+  worker.visited.emplace_back(task.path, std::move(directory));
+}
+
+void AttributeScanner::check(Worker& worker, std::size_t index,
+                             const AttributeEntry& entry)
+{
+  if (m_Backend.isProblematic(entry.attributes)) {
+    qDebug() << m_Backend.describe(entry.attributes, entry.path);
+    worker.found << entry.path;
+  }
+  if (entry.descend) {
+    push(index, Task{entry.path, entry.modified});
+  }
+}
+
+void AttributeScanner::push(std::size_t index, Task task)
+{
+  ++m_Pending;
+  ++m_Discovered;
+
+  Worker& worker = *m_Workers[index];
+  std::scoped_lock lock(worker.mutex);
+  worker.queue.push_back(std::move(task));
+}
+
+bool AttributeScanner::next(std::size_t index, Task& task)
+{
+  {
+    Worker& worker = *m_Workers[index];
+    std::scoped_lock lock(worker.mutex);
+    if (!worker.queue.empty()) {
+      task = std::move(worker.queue.back());
+      worker.queue.pop_back();
+      return true;
+    }
+  }
+
+  // steal the oldest entry of another worker, it is likely the largest subtree
+  for (std::size_t i = 1; i < m_Workers.size(); ++i) {
+    Worker& victim = *m_Workers[(index + i) % m_Workers.size()];
+    std::scoped_lock lock(victim.mutex);
+    if (!victim.queue.empty()) {
+      task = std::move(victim.queue.front());
+      victim.queue.pop_front();
+      return true;
+    }
+  }
+
+  return false;
+}
@@ -0,0 +1,108 @@
+/*
+Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+
+This file is part of basic diagnosis plugin for MO
+
+This plugin is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This plugin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ATTRIBUTESCANNER_H
+#define ATTRIBUTESCANNER_H
+
+#include "attributebackend.h"
+#include "attributecache.h"
+
+#include <QStringList>
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// walks directory trees on a pool of threads looking for problematic file attributes
+//
+// every worker owns a queue of directories, new subdirectories are pushed to the back
+// of the own queue and idle workers steal from the front of the others, so deep and
+// wide trees both keep all threads busy
+//
+// with a cache from a previous scan, directories that were clean and have not been
+// written to since are not listed again, only their subdirectories are probed
+class AttributeScanner
+{
+public:
+  explicit AttributeScanner(const AttributeBackend& backend);
+
+  // checks the given roots and everything below them, returns the sorted native
+  // paths of the entries with problematic attributes
+  //
+  // the cache is used to skip unchanged directories and is replaced by the results of
+  // this scan unless it is canceled
+  QStringList scan(const QStringList& roots, AttributeCache& cache);
+
+  // stops the scan in progress, may be called from any thread
+  void cancel() { m_Canceled = true; }
+  bool isCanceled() const { return m_Canceled; }
+
+  // number of directories visited and found so far, for progress reporting
+  const std::atomic<int>& scanned() const { return m_Scanned; }
+  const std::atomic<int>& discovered() const { return m_Discovered; }
+
+  // number of directories that were not listed because the cache was up to date
+  int skipped() const { return m_Skipped; }
+
+private:
+  // directories written to this recently are never cached as clean, since a change
+  // within the timestamp resolution of the file system would go unnoticed
+  static constexpr std::int64_t RACY_INTERVAL = 5000;
+
+  struct Task
+  {
+    QString path;
+    std::int64_t modified;
+  };
+
+  struct Worker
+  {
+    std::mutex mutex;
+    std::deque<Task> queue;
+
+    // only touched by the owning thread
+    QStringList found;
+    std::vector<std::pair<QString, AttributeCache::Directory>> visited;
+  };
+
+  void run(std::size_t index);
+  void visit(Worker& worker, std::size_t index, const Task& task,
+             std::vector<AttributeEntry>& entries);
+  void check(Worker& worker, std::size_t index, const AttributeEntry& entry);
+  void push(std::size_t index, Task task);
+  bool next(std::size_t index, Task& task);
+
+  const AttributeBackend& m_Backend;
+  std::vector<std::unique_ptr<Worker>> m_Workers;
+
+  // cache of the previous scan, only read while the workers run
+  const AttributeCache* m_Previous = nullptr;
+  std::int64_t m_Started           = 0;
+
+  // directories queued or being listed, the scan is done when this drops to zero
+  std::atomic<int> m_Pending    = 0;
+  std::atomic<int> m_Scanned    = 0;
+  std::atomic<int> m_Discovered = 0;
+  std::atomic<int> m_Skipped    = 0;
+  std::atomic<bool> m_Canceled  = false;
+};
+
+#endif  // ATTRIBUTESCANNER_H
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "checkmetrics.h"
+
+#include <QDebug>
+
+#include <algorithm>
+
+// run of the check executing on this thread, null outside of a check
+static thread_local CheckRun* t_Current = nullptr;
+
+CheckMetrics::Scope::Scope(CheckMetrics& metrics, unsigned int key, const char* name)
+    : m_Metrics(metrics), m_Run{key, name}, m_Outer(t_Current),
+      m_Started(std::chrono::steady_clock::now())
+{
+  t_Current = &m_Run;
+}
+
+CheckMetrics::Scope::~Scope()
+{
+  t_Current      = m_Outer;
+  m_Run.finished = QDateTime::currentDateTime();
+  m_Run.duration = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - m_Started);
+  m_Metrics.record(m_Run);
+}
+
+void CheckMetrics::Scope::addInput(const InputTimes& times)
+{
+  auto it = times.find(m_Run.key);
+  if (it != times.end()) {
+    m_Run.input += it->second;
+  }
+}
+
+bool CheckMetrics::Scope::finish(bool active)
+{
+  m_Run.active = active;
+  return active;
+}
+
+CheckMetrics::InputScope::InputScope(InputTimes& times,
+                                     const std::set<unsigned int>& running,
+                                     std::initializer_list<unsigned int> keys)
+    : m_Times(times), m_Started(std::chrono::steady_clock::now())
+{
+  for (unsigned int key : keys) {
+    if (running.contains(key)) {
+      m_Keys.push_back(key);
+    }
+  }
+}
+
+CheckMetrics::InputScope::~InputScope()
+{
+  const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - m_Started);
+  for (unsigned int key : m_Keys) {
+    m_Times[key] += elapsed;
+  }
+}
+
+void CheckMetrics::addFiles(std::uint64_t count)
+{
+  if (t_Current != nullptr) {
+    t_Current->files += count;
+  }
+}
+
+void CheckMetrics::addBytes(std::uint64_t bytes)
+{
+  if (t_Current != nullptr) {
+    t_Current->bytes += bytes;
+  }
+}
+
+void CheckMetrics::addCacheHit()
+{
+  if (t_Current != nullptr) {
+    ++t_Current->cacheHits;
+  }
+}
+
+std::vector<CheckRun> CheckMetrics::history() const
+{
+  std::vector<CheckRun> runs;
+  {
+    std::scoped_lock lock(m_Mutex);
+    for (const auto& [key, checkRuns] : m_Runs) {
+      runs.insert(runs.end(), checkRuns.begin(), checkRuns.end());
+    }
+  }
+
+  std::stable_sort(runs.begin(), runs.end(), [](const CheckRun& a, const CheckRun& b) {
+    return a.finished < b.finished;
+  });
+  return runs;
+}
+
+void CheckMetrics::record(const CheckRun& run)
+{
+  // one line per run with fixed keys, so the log can be filtered and parsed
+  qDebug().noquote() << QString("diagnose check=%1 result=%2 time_us=%3 input_us=%4 "
+                                "files=%5 bytes=%6 cache_hits=%7")
+                            .arg(run.name)
+                            .arg(run.active ? 1 : 0)
+                            .arg(run.duration.count())
+                            .arg(run.input.count())
+                            .arg(run.files)
+                            .arg(run.bytes)
+                            .arg(run.cacheHits);
+
+  std::scoped_lock lock(m_Mutex);
+  std::deque<CheckRun>& runs = m_Runs[run.key];
+  runs.push_back(run);
+  while (runs.size() > MAX_RUNS) {
+    runs.pop_front();
+  }
+}
@@ -0,0 +1,130 @@
+/*
+Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+
+This file is part of basic diagnosis plugin for MO
+
+This plugin is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This plugin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CHECKMETRICS_H
+#define CHECKMETRICS_H
+
+#include <QDateTime>
+#include <QString>
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <initializer_list>
+#include <map>
+#include <mutex>
+#include <set>
+#include <vector>
+
+// measurements of a single run of a check
+struct CheckRun
+{
+  unsigned int key;
+  const char* name;
+  QDateTime finished;
+  std::chrono::microseconds duration{0};
+
+  // time spent reading the input of the check on the calling thread before it was
+  // started, not part of the duration
+  std::chrono::microseconds input{0};
+
+  // files walked on disk or in the virtual file tree
+  std::uint64_t files = 0;
+
+  // bytes read from files
+  std::uint64_t bytes = 0;
+
+  // lookups answered from one of the caches instead of the disk
+  std::uint64_t cacheHits = 0;
+
+  bool active = false;
+};
+
+// keeps the measurements of the last runs of the checks
+//
+// the counters are static so that the helpers used by the checks can report to them
+// without knowing which check they are running for, they only count while a Scope
+// is alive on the calling thread
+class CheckMetrics
+{
+public:
+  // runs kept for each check, so that the checks run on every pass do not push the
+  // runs of the others out of the history
+  static constexpr std::size_t MAX_RUNS = 10;
+
+  // time spent reading the input of each check, by key
+  using InputTimes = std::map<unsigned int, std::chrono::microseconds>;
+
+  // measures the check running on the current thread while in scope, the run is
+  // recorded and logged when the scope ends
+  class Scope
+  {
+  public:
+    Scope(CheckMetrics& metrics, unsigned int key, const char* name);
+    ~Scope();
+
+    Scope(const Scope&)            = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    // records the time spent reading the input of the check
+    void addInput(const InputTimes& times);
+
+    // stores the result of the check and returns it
+    bool finish(bool active);
+
+  private:
+    CheckMetrics& m_Metrics;
+    CheckRun m_Run;
+    CheckRun* m_Outer;
+    std::chrono::steady_clock::time_point m_Started;
+  };
+
+  // adds the time spent in scope to those of the given checks that are about to
+  // run, input shared by several checks counts for each of them
+  class InputScope
+  {
+  public:
+    InputScope(InputTimes& times, const std::set<unsigned int>& running,
+               std::initializer_list<unsigned int> keys);
+    ~InputScope();
+
+    InputScope(const InputScope&)            = delete;
+    InputScope& operator=(const InputScope&) = delete;
+
+  private:
+    InputTimes& m_Times;
+    std::vector<unsigned int> m_Keys;
+    std::chrono::steady_clock::time_point m_Started;
+  };
+
+  static void addFiles(std::uint64_t count = 1);
+  static void addBytes(std::uint64_t bytes);
+  static void addCacheHit();
+
+  // recorded runs of all checks, oldest first
+  std::vector<CheckRun> history() const;
+
+private:
+  void record(const CheckRun& run);
+
+  mutable std::mutex m_Mutex;
+  std::map<unsigned int, std::deque<CheckRun>> m_Runs;
+};
+
+#endif  // CHECKMETRICS_H
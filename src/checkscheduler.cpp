@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "checkscheduler.h"
+
+#include <QDebug>
+
+#include <algorithm>
+#include <memory>
+
+CheckScheduler::CheckScheduler()
+{
+  m_Pool.setObjectName("diagnose_basic checks");
+}
+
+void CheckScheduler::onCheckFinished(FinishedCallback callback)
+{
+  m_Finished = std::move(callback);
+}
+
+void CheckScheduler::start(unsigned int key, Check check)
+{
+  std::scoped_lock lock(m_Mutex);
+  if (m_Tasks.contains(key)) {
+    return;
+  }
+
+  auto promise = std::make_shared<std::promise<bool>>();
+  m_Tasks[key] = Task{m_NextId++, promise->get_future().share(), Clock::now()};
+
+  m_Pool.start([key, promise, check = std::move(check), finished = m_Finished]() {
+    try {
+      promise->set_value(check());
+    } catch (...) {
+      promise->set_exception(std::current_exception());
+    }
+
+    if (finished) {
+      finished(key);
+    }
+  });
+}
+
+bool CheckScheduler::isRunning(unsigned int key) const
+{
+  std::scoped_lock lock(m_Mutex);
+  return m_Tasks.contains(key);
+}
+
+bool CheckScheduler::hasFinished() const
+{
+  std::scoped_lock lock(m_Mutex);
+  return std::any_of(m_Tasks.begin(), m_Tasks.end(), [](auto const& task) {
+    return task.second.result.wait_for(std::chrono::seconds(0)) ==
+           std::future_status::ready;
+  });
+}
+
+std::map<unsigned int, bool> CheckScheduler::wait(std::chrono::milliseconds timeout)
+{
+  // the tasks are waited for on a copy so that other threads can start and query
+  // checks in the meantime
+  std::map<unsigned int, Task> tasks;
+  {
+    std::scoped_lock lock(m_Mutex);
+    tasks = m_Tasks;
+  }
+
+  std::map<unsigned int, bool> results;
+  std::map<unsigned int, std::uint64_t> collected;
+  for (const auto& [key, task] : tasks) {
+    if (task.result.wait_until(task.started + timeout) != std::future_status::ready) {
+      if (timeout.count() > 0) {
+        qWarning() << "check" << key << "did not finish within" << timeout.count()
+                   << "ms";
+      }
+      continue;
+    }
+
+    try {
+      results[key] = task.result.get();
+    } catch (const std::exception& e) {
+      qWarning() << "check" << key << "failed:" << e.what();
+      results[key] = false;
+    }
+    collected[key] = task.id;
+  }
+
+  // another wait() may have collected the same task already and the check may have
+  // been started again since
+  std::scoped_lock lock(m_Mutex);
+  for (const auto& [key, id] : collected) {
+    auto iter = m_Tasks.find(key);
+    if (iter != m_Tasks.end() && iter->second.id == id) {
+      m_Tasks.erase(iter);
+    }
+  }
+
+  return results;
+}
@@ -0,0 +1,91 @@
+/*
+Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+
+This file is part of basic diagnosis plugin for MO
+
+This plugin is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This plugin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CHECKSCHEDULER_H
+#define CHECKSCHEDULER_H
+
+#include <QThreadPool>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+
+// runs independent checks concurrently on a worker pool
+//
+// checks are identified by their problem key, a check that is still running from a
+// previous pass is never started twice, its pending result is picked up by the next
+// call to wait() instead
+//
+// every function may be called from any thread
+class CheckScheduler
+{
+public:
+  using Check = std::function<bool()>;
+  using Clock = std::chrono::steady_clock;
+
+  using FinishedCallback = std::function<void(unsigned int key)>;
+
+  CheckScheduler();
+
+  // sets a callback that is invoked on the worker thread whenever a check finishes
+  void onCheckFinished(FinishedCallback callback);
+
+  // starts the given check on the pool unless it is already running
+  void start(unsigned int key, Check check);
+
+  // returns true if the check with the given key is running or has finished without
+  // its result having been collected by wait()
+  bool isRunning(unsigned int key) const;
+
+  // returns true if at least one check has finished and its result has not been
+  // collected yet
+  bool hasFinished() const;
+
+  // waits for every running check until it finishes or until its own timeout,
+  // counted from the time it was started, has expired
+  //
+  // returns the results of the checks that have finished, ordered by key; checks
+  // that timed out keep running and are not part of the result
+  //
+  // a timeout of zero only collects the checks that are already finished
+  std::map<unsigned int, bool> wait(std::chrono::milliseconds timeout);
+
+private:
+  struct Task
+  {
+    // tells a task apart from a later one started with the same key
+    std::uint64_t id;
+
+    std::shared_future<bool> result;
+    Clock::time_point started;
+  };
+
+  QThreadPool m_Pool;
+
+  // guards the tasks, it is never held while waiting for a check
+  mutable std::mutex m_Mutex;
+  std::map<unsigned int, Task> m_Tasks;
+  std::uint64_t m_NextId = 0;
+  FinishedCallback m_Finished;
+};
+
+#endif  // CHECKSCHEDULER_H
@@ -19,11 +19,17 @@
 
 #include "diagnosebasic.h"
 
+#include "archivelisting.h"
+#include "attributebackend.h"
+#include "attributerepairer.h"
+#include "attributescanner.h"
+
 #include <uibase/ifiletree.h>
 #include <uibase/imodinterface.h>
 #include <uibase/imodlist.h>
 #include <uibase/iplugingame.h>
 #include <uibase/ipluginlist.h>
+#include <uibase/iprofile.h>
 #include <uibase/report.h>
 #include <uibase/utility.h>
 
@@ -32,47 +38,151 @@
 #include <QDebug>
 #include <QDir>
 #include <QDirIterator>
+#include <QEventLoop>
 #include <QFile>
+#include <QFileInfo>
 #include <QLabel>
+#include <QLocale>
 #include <QMessageBox>
 #include <QProgressDialog>
 #include <QPushButton>
+#include <QThreadPool>
+#include <QTimer>
 #include <QtPlugin>
 
 #include <algorithm>
+#include <atomic>
 #include <functional>
-#include <regex>
+#include <numeric>
+#include <queue>
 #include <vector>
 
 using namespace MOBase;
 
 const QRegularExpression DiagnoseBasic::RE_LOG_FILE(".*[.]log[0-9]*$");
 
-DiagnoseBasic::DiagnoseBasic() : m_MOInfo(nullptr) {}
+DiagnoseBasic::DiagnoseBasic()
+    : m_MOInfo(nullptr), m_FontConfigs(&FontConfig::parse),
+      m_ProfileTweaks([](const QByteArray& data) {
+        return decodeTextData(data);
+      }),
+      m_OverwriteWatcher(RE_LOG_FILE), m_NotifyInvalidated([this]() {
+        invalidate();
+      })
+{}
 
 bool DiagnoseBasic::init(IOrganizer* moInfo)
 {
   m_MOInfo = moInfo;
 
+  // each event only invalidates the checks that actually depend on it, the error
+  // log and profile tweaks checks are cheap and are always re-evaluated
   m_MOInfo->modList()->onModStateChanged(
       [&](const std::map<QString, IModList::ModStates>& mods) {
-        if (mods.contains("Overwrite"))
-          invalidate();
+        invalidateMods();
+        if (mods.contains("Overwrite")) {
+          invalidateChecks({PROBLEM_OVERWRITE, PROBLEM_ALTERNATE});
+        } else {
+          invalidateChecks({PROBLEM_ALTERNATE});
+        }
       });
-  m_MOInfo->modList()->onModMoved([&](const QString&, int, int) {
-    // invalidates only the assetOrder check but there is currently no way to recheck
-    // individual checks
-    invalidate();
+  // the snapshot of the mods is also dropped when a mod is installed or removed, a
+  // new mod may provide a missing master
+  m_MOInfo->modList()->onModInstalled([&](IModInterface*) {
+    invalidateMods();
+    invalidateChecks({PROBLEM_ASSETORDER, PROBLEM_MISSINGMASTERS, PROBLEM_ALTERNATE});
+  });
+  m_MOInfo->modList()->onModRemoved([&](const QString&) {
+    invalidateMods();
+    invalidateChecks({PROBLEM_ASSETORDER, PROBLEM_MISSINGMASTERS, PROBLEM_ALTERNATE});
   });
-  m_MOInfo->pluginList()->onPluginMoved([&](const QString&, int, int) {
-    invalidate();
+  m_MOInfo->modList()->onModMoved([&](const QString&, int, int) {
+    // the mod order decides which file wins in the virtual file system
+    invalidateMods();
+    invalidateChecks(
+        {PROBLEM_INVALIDFONT, PROBLEM_NITPICKINSTALLED, PROBLEM_ASSETORDER});
   });
+  // the plugin graph is updated with each change instead of being rebuilt by the
+  // missing masters check
+  m_MOInfo->pluginList()->onPluginMoved(
+      [&](const QString& name, int oldPriority, int newPriority) {
+        if (!m_Batching) {
+          m_PluginGraph.updatePriority(name, oldPriority, newPriority);
+        }
+        invalidateChecks({PROBLEM_MISSINGMASTERS, PROBLEM_ASSETORDER});
+      });
   m_MOInfo->pluginList()->onRefreshed([&]() {
-    invalidate();
+    // mods are installed and removed through a refresh, which is also how files
+    // written to the overwrite directory outside of a run are picked up
+    invalidateMods();
+    if (!m_Batching) {
+      m_PluginGraph.rebuild(m_MOInfo->pluginList());
+    }
+    invalidateChecks({PROBLEM_INVALIDFONT, PROBLEM_NITPICKINSTALLED,
+                      PROBLEM_MISSINGMASTERS, PROBLEM_ASSETORDER, PROBLEM_OVERWRITE});
+  });
+  m_MOInfo->pluginList()->onPluginStateChanged(
+      [&](const std::map<QString, IPluginList::PluginStates>& states) {
+        if (!m_Batching) {
+          m_PluginGraph.updateStates(states);
+        }
+        invalidateChecks({PROBLEM_MISSINGMASTERS, PROBLEM_ASSETORDER});
+      });
+  m_MOInfo->onFinishedRun([&](const QString&, unsigned int) {
+    // tools commonly write their output to the overwrite directory
+    invalidateChecks({PROBLEM_OVERWRITE});
+  });
+  m_MOInfo->onProfileChanged([&](IProfile*, IProfile*) {
+    invalidateMods();
+    invalidateAllChecks();
+  });
+  m_MOInfo->onPluginSettingChanged([&](const QString& pluginName, const QString& key,
+                                       const QVariant&, const QVariant& value) {
+    if (pluginName != name()) {
+      return;
+    }
+
+    if (key == "check_overwrite") {
+      if (value.toBool()) {
+        m_OverwriteWatcher.watch(m_MOInfo->overwritePath());
+      } else {
+        m_OverwriteWatcher.stop();
+      }
+    }
+
+    // the settings are read again on the next use, any of them can change the
+    // result of a check
+    {
+      std::scoped_lock lock(m_SettingsMutex);
+      m_Settings.reset();
+    }
+    invalidateAllChecks();
+  });
+
+  // external tools may write to the overwrite directory at any time
+  connect(&m_OverwriteWatcher, &OverwriteWatcher::changed, this, [this]() {
+    invalidateChecks({PROBLEM_OVERWRITE});
   });
-  m_MOInfo->pluginList()->onPluginStateChanged([&](auto const&) {
-    invalidate();
+  // the directory is only watched while the check is enabled
+  m_MOInfo->onUserInterfaceInitialized([this](QMainWindow*) {
+    if (currentSettings().checkOverwrite) {
+      m_OverwriteWatcher.watch(m_MOInfo->overwritePath());
+    }
+  });
+
+  // checks finishing after activeProblems() stopped waiting for them are collected
+  // by the next pass, which is triggered here on the gui thread
+  m_Scheduler.onCheckFinished([this](unsigned int) {
+    QMetaObject::invokeMethod(
+        this,
+        [this]() {
+          if (m_Scheduler.hasFinished()) {
+            invalidate();
+          }
+        },
+        Qt::QueuedConnection);
   });
+
   m_MOInfo->onAboutToRun([&](const QString& executable) {
     return fileAttributes(executable);
   });
@@ -123,6 +233,10 @@ QList<PluginSetting> DiagnoseBasic::settings() const
                 "check_conflict",
                 tr("Warn when mods are installed that conflict with MO functionality"),
                 true)
+         << PluginSetting("check_assetorder",
+                          tr("Warn when the load order of plugins does not match the "
+                             "priority of the mods providing their scripts"),
+                          false)
          << PluginSetting("check_missingmasters",
                           tr("Warn when there are esps with missing masters"), true)
          << PluginSetting(
@@ -131,6 +245,16 @@ QList<PluginSetting> DiagnoseBasic::settings() const
                 false)
          << PluginSetting("check_fileattributes",
                           tr("Warn when files have unwanted attributes"), false)
+         << PluginSetting("async_checks",
+                          tr("Run checks in the background and update the list of "
+                             "problems as they finish"),
+                          false)
+         << PluginSetting("log_include_warnings",
+                          tr("Also list warnings when reporting errors from the log"),
+                          false)
+         << PluginSetting("show_check_timings",
+                          tr("List the time taken by the recent checks as a problem"),
+                          false)
          << PluginSetting(
                 "ow_ignore_empty",
                 tr("Ignore empty directories when checking overwrite directory"), false)
@@ -140,72 +264,75 @@ QList<PluginSetting> DiagnoseBasic::settings() const
                           false);
 }
 
-bool DiagnoseBasic::errorReported() const
+bool DiagnoseBasic::errorReported(const CheckInput& input) const
 {
-  QDir dir(qApp->property("dataPath").toString() + "/logs");
+  QDir dir(input.dataPath + "/logs");
   QFileInfoList files =
       dir.entryInfoList(QStringList("ModOrganizer_??_??_??_??_??.log"), QDir::Files,
                         QDir::Name | QDir::Reversed);
 
-  if (files.count() > 0) {
-    QString logFile = files.at(0).absoluteFilePath();
-    QFile file(logFile);
-    if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-      char buffer[1024];
-      int line = 0;
-      qint64 lineLengths[NUM_CONTEXT_ROWS];
-      for (int i = 0; i < NUM_CONTEXT_ROWS; ++i) {
-        lineLengths[i] = 0;
-      }
-      while (!file.atEnd()) {
-        lineLengths[line % NUM_CONTEXT_ROWS] = file.readLine(buffer, 1024) + 1;
-        if (strncmp(buffer, "ERROR", 5) == 0) {
-          qint64 sumChars = 0;
-          for (int i = 0; i < NUM_CONTEXT_ROWS; ++i) {
-            sumChars += lineLengths[i];
-          }
-          file.seek(file.pos() - sumChars);
-          m_ErrorMessage = "";
-          for (int i = 0; i < 2 * NUM_CONTEXT_ROWS; ++i) {
-            file.readLine(buffer, 1024);
-            QString lineString = QString::fromUtf8(buffer);
-            if (lineString.startsWith("ERROR")) {
-              m_ErrorMessage += "<b>" + lineString + "</b>";
-            } else {
-              m_ErrorMessage += lineString;
-            }
-          }
-          return true;
-        }
+  if (files.count() == 0) {
+    m_LogScanner.reset();
+    return false;
+  }
 
-        // prevent this function from taking forever
-        if (line++ >= 50000) {
-          break;
-        }
-      }
-    }
+  // the scanner only looks at the part of the log written since the last pass
+  if (!m_LogScanner.scan(files.at(0).absoluteFilePath(), NUM_CONTEXT_ROWS,
+                         input.settings.logIncludeWarnings)) {
+    return false;
   }
 
-  return false;
-}
+  QString entryInfo;
+  for (const LogScanner::Entry& entry : m_LogScanner.entries()) {
+    entryInfo += "<tr>";
+    entryInfo += "<td style=\"padding-left: 20px\">" +
+                 (entry.error ? tr("Error") : tr("Warning")) + "</td>";
+    entryInfo +=
+        "<td style=\"padding-left: 20px\">" + QString::number(entry.count) + "</td>";
+    entryInfo += "<td style=\"padding-left: 20px\">" + entry.firstTime + "</td>";
+    entryInfo += "<td style=\"padding-left: 20px\">" + entry.lastTime + "</td>";
+    entryInfo +=
+        "<td style=\"padding-left: 20px\">" + entry.message.toHtmlEscaped() + "</td>";
+    entryInfo += "</tr>";
+  }
 
-bool DiagnoseBasic::checkEmpty(QString const& path) const
-{
-  QDir dir(path);
-  dir.setFilter(QDir::Files | QDir::Hidden | QDir::System);
+  QString errorMessage =
+      "<table><tr><th style=\"padding-left: 20px; text-align: left\">" + tr("Level") +
+      "</th><th style=\"padding-left: 20px; text-align: left\">" + tr("Count") +
+      "</th><th style=\"padding-left: 20px; text-align: left\">" + tr("First") +
+      "</th><th style=\"padding-left: 20px; text-align: left\">" + tr("Last") +
+      "</th><th style=\"padding-left: 20px; text-align: left\">" + tr("Message") +
+      "</th></tr>" + entryInfo + "</table>";
+  if (m_LogScanner.unlisted() > 0) {
+    errorMessage +=
+        tr("%1 more entries are not listed.<br>").arg(m_LogScanner.unlisted());
+  }
 
-  // Search files first
-  for (auto const& file : dir.entryList()) {
-    if (!m_MOInfo->pluginSetting(name(), "ow_ignore_log").toBool() ||
-        !RE_LOG_FILE.match(file).hasMatch()) {
-      return false;
+  errorMessage += "<hr><i>" + tr("Most recent error:") + "</i><br><code>";
+  for (const QString& line : m_LogScanner.context()) {
+    if (line.startsWith("ERROR")) {
+      errorMessage += "<b>" + line.toHtmlEscaped() + "</b><br>";
+    } else {
+      errorMessage += line.toHtmlEscaped() + "<br>";
     }
   }
+  errorMessage += "</code>";
+
+  std::scoped_lock lock(m_Mutex);
+  m_ErrorMessage = errorMessage;
+  return true;
+}
 
-  // Then directories
-  dir.setFilter(QDir::AllDirs | QDir::NoDotAndDotDot | QDir::NoSymLinks);
-  for (QFileInfo const& subdir : dir.entryInfoList()) {
-    if (!checkEmpty(subdir.absoluteFilePath())) {
+bool DiagnoseBasic::checkEmpty(QString const& path, bool ignoreLog) const
+{
+  // empty directories never count, so only files are listed; the iterator streams
+  // the tree and stops at the first file that is not ignored
+  QDirIterator iter(path, QDir::Files | QDir::Hidden | QDir::System,
+                    QDirIterator::Subdirectories);
+  while (iter.hasNext()) {
+    iter.next();
+    CheckMetrics::addFiles();
+    if (!ignoreLog || !RE_LOG_FILE.match(iter.fileName()).hasMatch()) {
       return false;
     }
   }
@@ -213,37 +340,76 @@ bool DiagnoseBasic::checkEmpty(QString const& path) const
   return true;
 }
 
-bool DiagnoseBasic::overwriteFiles() const
+bool DiagnoseBasic::overwriteFiles(const CheckInput& input) const
+{
+  const bool content = overwriteContent(input);
+
+  // the breakdown takes a walk of the directory, so it is built here on the worker
+  // pool rather than when the description is shown on the gui thread
+  std::shared_ptr<const OverwriteSummary> summary;
+  if (content) {
+    summary = std::make_shared<const OverwriteSummary>(
+        OverwriteSummary::scan(input.overwritePath));
+  }
+
+  std::scoped_lock lock(m_Mutex);
+  m_OverwriteSummary = summary;
+  return content;
+}
+
+bool DiagnoseBasic::overwriteContent(const CheckInput& input) const
 {
   // QString dirname(qApp->property("dataPath").toString() + "/overwrite");
-  QString dirname(m_MOInfo->overwritePath());
-  if (m_MOInfo->pluginSetting(name(), "ow_ignore_empty").toBool() ||
-      m_MOInfo->pluginSetting(name(), "ow_ignore_log").toBool()) {
-    return !checkEmpty(dirname);
-  }
-  QDir dir(dirname);
-  bool checkDirs = m_MOInfo->managedGame()->getModMappings().keys().size() > 1 ||
-                   m_MOInfo->managedGame()->getModMappings().keys().first() != "";
+  QString dirname(input.overwritePath);
+  const bool ignoreLog   = input.settings.ignoreLog;
+  const bool ignoreEmpty = input.settings.ignoreEmpty;
+
+  const QStringList& mappings = input.modMappings;
+
+  // the watcher keeps track of the directory, the tree is only walked when it could
+  // not watch every directory
+  if (auto content = m_OverwriteWatcher.hasContent(mappings, ignoreEmpty, ignoreLog)) {
+    CheckMetrics::addCacheHit();
+    return *content;
+  }
+
+  if (ignoreLog || ignoreEmpty) {
+    return !checkEmpty(dirname, ignoreLog);
+  }
+
+  // isEmpty() stops at the first entry instead of listing the whole directory
+  const QDir::Filters filters = QDir::AllEntries | QDir::NoDotAndDotDot;
+
+  bool checkDirs = mappings.size() > 1 || (!mappings.isEmpty() && mappings[0] != "");
   if (checkDirs) {
-    bool empty = true;
-    for (auto dir : m_MOInfo->managedGame()->getModMappings().keys()) {
-      auto mapDir = QDir(dirname).filePath(dir);
-      if (QDir(mapDir).exists()) {
-        empty = QDir(mapDir).count() == 2;  // account for . and ..
+    for (const QString& mapping : mappings) {
+      QDir mapDir(QDir(dirname).filePath(mapping));
+      if (mapDir.exists() && !mapDir.isEmpty(filters)) {
+        return true;
       }
-      if (!empty)
-        break;
     }
-    return !empty;
+    return false;
   }
-  return dir.count() != 2;  // account for . and ..
+  return !QDir(dirname).isEmpty(filters);
 }
 
-bool DiagnoseBasic::nitpickInstalled() const
+bool DiagnoseBasic::nitpickInstalled(const CheckInput& input) const
 {
-  QString path = m_MOInfo->resolvePath("skse/plugins/nitpick.dll");
+  // the file is looked up along with the rest of the input
+  return input.nitpickInstalled;
+}
 
-  return !path.isEmpty();
+bool DiagnoseBasic::checkTimings(const CheckInput&) const
+{
+  // the entry is only listed when enabled, its content is built by the description
+  return true;
+}
+
+bool DiagnoseBasic::profileTweaks(const CheckInput& input) const
+{
+  // the content is kept for the description
+  const QString path = QDir(input.profilePath).filePath(PROFILE_TWEAKS);
+  return m_ProfileTweaks.get(path) != nullptr;
 }
 
 /// unused code to remove duplicates from a vector
@@ -265,248 +431,405 @@ void makeUnique(std::vector<T>& vector)
   vector.erase(write, vector.end());
 }
 
-bool DiagnoseBasic::missingMasters() const
+QSet<QString> DiagnoseBasic::relevantScripts(const QString& directory,
+                                             const QStringList& archives,
+                                             const QString& plugin) const
 {
-  std::set<QString> enabledPlugins;
+  // loose files always win over archives, so only the scripts packed in archives
+  // depend on the load order; the game loads the archives named after the plugin
+  const QString base = QFileInfo(plugin).completeBaseName();
+
+  QSet<QString> scripts;
+  for (const QString& archive : archives) {
+    if (!archive.startsWith(base + ".", Qt::CaseInsensitive) &&
+        !archive.startsWith(base + " - ", Qt::CaseInsensitive)) {
+      continue;
+    }
 
-  QStringList esps = m_MOInfo->findFiles("", [](const QString& fileName) -> bool {
-    return fileName.endsWith(".esp", FileNameComparator::CaseSensitivity) ||
-           fileName.endsWith(".esm", FileNameComparator::CaseSensitivity) ||
-           fileName.endsWith(".esl", FileNameComparator::CaseSensitivity);
-  });
-  // gather enabled masters first
-  for (const QString& esp : esps) {
-    QString baseName = QFileInfo(esp).fileName();
-    if (m_MOInfo->pluginList()->state(baseName) == IPluginList::STATE_ACTIVE) {
-      enabledPlugins.insert(baseName.toLower());
-    }
-  }
-
-  m_MissingMasters.clear();
-  m_PluginChildren.clear();
-  // for each required master in each esp, test if it's in the list of enabled masters.
-  for (const QString& esp : esps) {
-    QString baseName = QFileInfo(esp).fileName();
-    if (m_MOInfo->pluginList()->state(baseName) == IPluginList::STATE_ACTIVE) {
-      for (const QString master : m_MOInfo->pluginList()->masters(baseName)) {
-        if (enabledPlugins.find(master.toLower()) == enabledPlugins.end()) {
-          m_MissingMasters.insert(master);
-          m_PluginChildren[master].insert(baseName);
-        }
+    const std::optional<QStringList> files =
+        ArchiveListing::files(QDir(directory).filePath(archive), "scripts");
+    if (!files) {
+      continue;
+    }
+
+    CheckMetrics::addFiles(files->size());
+    for (const QString& file : *files) {
+      if (file.endsWith(".pex")) {
+        scripts.insert(file);
       }
     }
   }
-  return !m_MissingMasters.empty();
+
+  return scripts;
 }
 
-bool DiagnoseBasic::alternateGame() const
+bool DiagnoseBasic::assetOrder(const CheckInput& input) const
 {
-  QStringList mods = m_MOInfo->modList()->allMods();
-  for (QString mod : mods) {
-    if (m_MOInfo->modList()->state(mod) & MOBase::IModList::STATE_ALTERNATE &&
-        m_MOInfo->modList()->state(mod) & MOBase::IModList::STATE_ACTIVE)
-      return true;
+  // a mod may contain several plugins, its archives are only listed once
+  QHash<QString, QStringList> modArchives;
+
+  std::vector<ListElement> list;
+  for (const ListElement& plugin : input.assetPlugins) {
+    const QString& path = input.mods->find(plugin.modName)->path;
+
+    auto archives = modArchives.constFind(plugin.modName);
+    if (archives == modArchives.constEnd()) {
+      archives = modArchives.insert(
+          plugin.modName, QDir(path).entryList({"*.bsa", "*.ba2"}, QDir::Files));
+    }
+
+    QSet<QString> scripts = relevantScripts(path, *archives, plugin.espName);
+    if (scripts.isEmpty()) {
+      continue;
+    }
+
+    list.push_back(plugin);
+    list.back().relevantScripts = std::move(scripts);
   }
-  return false;
+
+  Sorter sorter = topoSort(list);
+
+  std::scoped_lock lock(m_Mutex);
+  m_AssetMoves  = std::move(sorter.moves);
+  m_AssetGroups = std::move(sorter.groups);
+  return !m_AssetMoves.empty();
 }
 
-bool DiagnoseBasic::invalidFontConfig() const
+DiagnoseBasic::Sorter DiagnoseBasic::topoSort(std::vector<ListElement>& list) const
 {
-  if ((m_MOInfo->managedGame()->gameName() != "Skyrim") &&
-      (m_MOInfo->managedGame()->gameShortName() != "SkyrimSE")) {
-    // this check is only for skyrim
-    return false;
+  // elements sharing a script end up in the same group, found with a union-find
+  std::vector<int> parent(list.size());
+  std::iota(parent.begin(), parent.end(), 0);
+  const auto root = [&parent](int index) {
+    while (parent[index] != index) {
+      parent[index] = parent[parent[index]];
+      index         = parent[index];
+    }
+    return index;
+  };
+
+  QHash<QString, int> firstOwner;
+  for (int i = 0; i < static_cast<int>(list.size()); ++i) {
+    for (const QString& script : list[i].relevantScripts) {
+      auto owner = firstOwner.constFind(script);
+      if (owner == firstOwner.constEnd()) {
+        firstOwner.insert(script, i);
+      } else {
+        parent[root(i)] = root(*owner);
+      }
+    }
   }
 
-  // files from skyrim_interface.bsa
-  static std::vector<QString> defaultFonts{"interface\\fonts_console.swf",
-                                           "interface\\fonts_en.swf",
-                                           "interface\\fonts_cclub.swf"};
-
-  QString configPath = m_MOInfo->resolvePath("interface/fontconfig.txt");
-  if (configPath.isEmpty()) {
-    return false;
-  }
-  QFile config(configPath);
-  if (!config.open(QIODevice::ReadOnly | QIODevice::Text)) {
-    qDebug("failed to open %s", qUtf8Printable(configPath));
-    return false;
+  for (int i = 0; i < static_cast<int>(list.size()); ++i) {
+    list[i].sortGroup = root(i);
   }
 
-  std::regex exp("^fontlib \"([^\"]*)\"$");
-  while (!config.atEnd()) {
-    QByteArray row = config.readLine();
-    std::cmatch match;
-    if (std::regex_search(row.constData(), match, exp)) {
-      std::string temp = match[1];
-      QString path(temp.c_str());
-      bool isDefault = false;
-      for (const QString& def : defaultFonts) {
-        if (QString::compare(def, path, FileNameComparator::CaseSensitivity) == 0) {
-          isDefault = true;
-          break;
-        }
-      }
+  // the moves of each group depend on their order, so they are not sorted
+  Sorter sorter;
+  sorter(list);
+  return sorter;
+}
 
-      if (!isDefault && m_MOInfo->resolvePath(path).isEmpty()) {
-        return true;
-      }
+void DiagnoseBasic::Sorter::operator()(std::vector<ListElement>& modList)
+{
+  std::sort(modList.begin(), modList.end(),
+            [](const ListElement& lhs, const ListElement& rhs) {
+              return lhs.sortGroup < rhs.sortGroup;
+            });
+
+  auto begin = modList.begin();
+  while (begin != modList.end()) {
+    auto end = std::find_if(begin, modList.end(), [&](const ListElement& element) {
+      return element.sortGroup != begin->sortGroup;
+    });
+    if (end - begin > 1) {
+      sortGroup(std::span<ListElement>(begin, end));
     }
+    begin = end;
   }
-  return false;
 }
 
-static bool checkFileAttributes(const QString& path)
+void DiagnoseBasic::Sorter::sortGroup(std::span<ListElement> modList)
 {
-  WCHAR w_path[32767];
-  memset(w_path, 0, sizeof(w_path));
-  path.toWCharArray(w_path);
-
-  DWORD attrs = GetFileAttributes(w_path);
-  if (attrs != INVALID_FILE_ATTRIBUTES) {
-    if (!(attrs & FILE_ATTRIBUTE_ARCHIVE) && !(attrs & FILE_ATTRIBUTE_NORMAL) &&
-        (attrs & ~(FILE_ATTRIBUTE_DIRECTORY | FILE_ATTRIBUTE_ARCHIVE))) {
-      QString debug;
-      debug += QString("%1 ").arg(attrs, 8, 16, QLatin1Char('0'));
+  // positions in the group are the current load order
+  std::sort(modList.begin(), modList.end(),
+            [](const ListElement& lhs, const ListElement& rhs) {
+              return lhs.pluginPriority < rhs.pluginPriority;
+            });
+  const int count = static_cast<int>(modList.size());
+
+  // for each script, the providing plugins have to load in the order of their mods,
+  // so an edge links each provider to the next one
+  QHash<QString, std::vector<int>> providers;
+  for (int i = 0; i < count; ++i) {
+    for (const QString& script : modList[i].relevantScripts) {
+      providers[script].push_back(i);
+    }
+  }
 
-      // A C D H I O P R S U V X Z
-      debug += (attrs & FILE_ATTRIBUTE_DIRECTORY) ? "D" : " ";
-      debug += (attrs & FILE_ATTRIBUTE_ARCHIVE) ? "A" : " ";
-      debug += (attrs & FILE_ATTRIBUTE_READONLY) ? "R" : " ";
-      debug += (attrs & FILE_ATTRIBUTE_SYSTEM) ? "S" : " ";
-      debug += (attrs & FILE_ATTRIBUTE_HIDDEN) ? "H" : " ";
-      debug += (attrs & FILE_ATTRIBUTE_OFFLINE) ? "O" : " ";
-      debug += (attrs & FILE_ATTRIBUTE_NOT_CONTENT_INDEXED) ? "I" : " ";
-      debug += (attrs & FILE_ATTRIBUTE_NO_SCRUB_DATA) ? "X" : " ";
-      debug += (attrs & FILE_ATTRIBUTE_INTEGRITY_STREAM) ? "V" : " ";
-      debug += (attrs & FILE_ATTRIBUTE_PINNED) ? "P" : " ";
-      debug += (attrs & FILE_ATTRIBUTE_UNPINNED) ? "U" : " ";
-      debug += (attrs & FILE_ATTRIBUTE_COMPRESSED) ? "C" : " ";
-      debug += (attrs & FILE_ATTRIBUTE_SPARSE_FILE) ? "Z" : " ";
+  std::vector<std::pair<int, int>> edges;
+  for (std::vector<int>& indices : providers) {
+    std::sort(indices.begin(), indices.end(), [&](int lhs, int rhs) {
+      return minMod(modList[lhs], modList[rhs]);
+    });
+    for (std::size_t i = 1; i < indices.size(); ++i) {
+      // plugins from the same mod are not constrained
+      if (minMod(modList[indices[i - 1]], modList[indices[i]])) {
+        edges.emplace_back(indices[i - 1], indices[i]);
+      }
+    }
+  }
 
-      debug += QString(" %1").arg(path);
+  // nothing to do for a group that already loads in order
+  if (std::all_of(edges.begin(), edges.end(), [](const std::pair<int, int>& edge) {
+        return edge.first < edge.second;
+      })) {
+    return;
+  }
 
-      qDebug() << debug;
+  // contiguous adjacency lists, indexed by offsets
+  std::vector<int> offsets(count + 1, 0);
+  std::vector<int> inDegree(count, 0);
+  for (auto [from, to] : edges) {
+    ++offsets[from + 1];
+    ++inDegree[to];
+  }
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  std::vector<int> targets(edges.size());
+  std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+  for (auto [from, to] : edges) {
+    targets[fill[from]++] = to;
+  }
 
-      return true;
+  // Kahn's algorithm, always taking the ready element that loads first so that
+  // elements that are not constrained keep their relative position; a plain queue
+  // would place them by their distance to the sources instead
+  std::priority_queue<int, std::vector<int>, std::greater<int>> ready;
+  for (int i = 0; i < count; ++i) {
+    if (inDegree[i] == 0) {
+      ready.push(i);
     }
-  } else {
-    DWORD error = ::GetLastError();
-    qWarning(qUtf8Printable(QString("Unable to get file attributes for %1 (error %2)")
-                                .arg(w_path)
-                                .arg(error)));
-  }
-  return false;
-}
-
-static bool fixFileAttributes(const QString& path)
-{
-  bool success = true;
-
-  WCHAR w_path[32767];
-  memset(w_path, 0, sizeof(w_path));
-  path.toWCharArray(w_path);
-
-  DWORD attrs = GetFileAttributes(w_path);
-  if (attrs != INVALID_FILE_ATTRIBUTES) {
-    // Clear all the attributes possible, except ARCHIVE, with SetFileAttributes
-    if (!SetFileAttributes(
-            w_path, attrs & FILE_ATTRIBUTE_ARCHIVE ? FILE_ATTRIBUTE_ARCHIVE : 0)) {
-      DWORD error = GetLastError();
-      qWarning(qUtf8Printable(QString("Unable to set file attributes for %1 (error %2)")
-                                  .arg(path)
-                                  .arg(error)));
-      success = false;
-    }
-
-    // Compression requires DeviceIoControl
-    if (attrs & FILE_ATTRIBUTE_COMPRESSED) {
-      HANDLE hndl = CreateFile(w_path, GENERIC_READ | GENERIC_WRITE,
-                               FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING,
-                               FILE_ATTRIBUTE_NORMAL, NULL);
-      if (hndl != INVALID_HANDLE_VALUE) {
-        USHORT compressionSetting = COMPRESSION_FORMAT_NONE;
-        DWORD bytesReturned       = 0;
-        if (!DeviceIoControl(hndl, FSCTL_SET_COMPRESSION, &compressionSetting,
-                             sizeof(compressionSetting), NULL, 0, &bytesReturned,
-                             NULL)) {
-          DWORD error = GetLastError();
-          qWarning(qUtf8Printable(
-              QString("Unable to disable compression for file %1 (error %2)")
-                  .arg(path)
-                  .arg(error)));
-          success = false;
-        }
-        CloseHandle(hndl);
-      } else {
-        DWORD error = GetLastError();
-        qWarning(qUtf8Printable(
-            QString("Unable to open file %1 (error %2)").arg(path).arg(error)));
-        success = false;
+  }
+  std::vector<int> order;
+  order.reserve(count);
+  while (!ready.empty()) {
+    const int current = ready.top();
+    ready.pop();
+    order.push_back(current);
+    for (int edge = offsets[current]; edge < offsets[current + 1]; ++edge) {
+      if (--inDegree[targets[edge]] == 0) {
+        ready.push(targets[edge]);
       }
     }
+  }
 
-    // Sparseness requires DeviceIoControl
-    if (attrs & FILE_ATTRIBUTE_SPARSE_FILE) {
-      HANDLE hndl = CreateFile(w_path, GENERIC_READ | GENERIC_WRITE,
-                               FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING,
-                               FILE_ATTRIBUTE_NORMAL, NULL);
-      if (hndl != INVALID_HANDLE_VALUE) {
-        FILE_SET_SPARSE_BUFFER setting = {FALSE};
-        DWORD bytesReturned            = 0;
-        if (!DeviceIoControl(hndl, FSCTL_SET_SPARSE, &setting, sizeof(setting), NULL, 0,
-                             &bytesReturned, NULL)) {
-          DWORD error = GetLastError();
-          qWarning(qUtf8Printable(
-              QString("Unable to disable sparseness for file %1 (error %2)")
-                  .arg(path)
-                  .arg(error)));
-          success = false;
-        }
-        CloseHandle(hndl);
-      } else {
-        DWORD error = GetLastError();
-        qWarning(qUtf8Printable(
-            QString("Unable to open file %1 (error %2)").arg(path).arg(error)));
-        success = false;
+  // the elements that can stay are the heaviest increasing subsequence of the
+  // current positions in the new order, elements that should not move weigh more
+  // than all the others together
+  std::vector<int> weight(count), best(count), previous(count, -1);
+  std::vector<int> tree(count + 1, -1);
+  const auto better = [&](int lhs, int rhs) {
+    return rhs < 0 || (lhs >= 0 && best[lhs] > best[rhs]);
+  };
+  int last = -1;
+  for (int index : order) {
+    weight[index] = modList[index].avoidMove ? count + 1 : 1;
+
+    // best chain ending at a position before this one, from a fenwick tree
+    int chain = -1;
+    for (int i = index; i > 0; i -= i & -i) {
+      if (better(tree[i], chain)) {
+        chain = tree[i];
       }
     }
+    best[index]     = weight[index] + (chain < 0 ? 0 : best[chain]);
+    previous[index] = chain;
+    for (int i = index + 1; i <= count; i += i & -i) {
+      if (better(index, tree[i])) {
+        tree[i] = index;
+      }
+    }
+    if (better(index, last)) {
+      last = index;
+    }
+  }
 
-    // As a last ditch effort, set the archive flag
-    if (!success) {
-      attrs = GetFileAttributes(w_path);
-      if (attrs != INVALID_FILE_ATTRIBUTES) {
-        if (!SetFileAttributes(w_path, attrs | FILE_ATTRIBUTE_ARCHIVE)) {
-          DWORD error = GetLastError();
-          qWarning(
-              qUtf8Printable(QString("Unable to set file attributes for %1 (error %2)")
-                                 .arg(path)
-                                 .arg(error)));
-        } else {
-          success = true;
+  std::vector<bool> keep(count, false);
+  for (int index = last; index >= 0; index = previous[index]) {
+    keep[index] = true;
+  }
+
+  // moves follow the new order: plugins ahead of the first kept one go right before
+  // it, any other one right after its predecessor in the new order, which is either
+  // kept or was placed by an earlier move
+  const std::size_t firstKept = std::distance(
+      order.begin(), std::find_if(order.begin(), order.end(), [&](int index) {
+        return keep[index];
+      }));
+  if (firstKept == order.size()) {
+    return;
+  }
+
+  SortedGroup group;
+  for (int index : order) {
+    group.plugins.append(modList[index].espName);
+    group.kept.push_back(keep[index]);
+  }
+  groups.push_back(std::move(group));
+
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    const ListElement& item = modList[order[i]];
+    if (keep[order[i]]) {
+      continue;
+    }
+    if (i < firstKept) {
+      moves.emplace_back(item, modList[order[firstKept]], Move::BEFORE);
+    } else {
+      moves.emplace_back(item, modList[order[i - 1]], Move::AFTER);
+    }
+  }
+}
+
+bool DiagnoseBasic::missingMasters(const CheckInput& input) const
+{
+  // the graph is kept up to date by the plugin list callbacks and built along with
+  // the input if no refresh happened yet
+  if (input.pluginGraphReused) {
+    CheckMetrics::addCacheHit();
+  }
+
+  PluginGraph::Problems problems = m_PluginGraph.problems();
+
+  // the plugin list only knows the plugins of active mods, the headers of the
+  // plugins in every mod tell which inactive mod would provide a missing master and
+  // what that copy requires in turn
+  std::map<QString, QString> sources;
+  if (!problems.missing.empty()) {
+    std::shared_ptr<const PluginProviders> providers = pluginProviders(input.mods);
+    for (const auto& [master, children] : problems.missing) {
+      QStringList mods;
+      for (const PluginProviders::Provider& provider : providers->find(master)) {
+        if (provider.active) {
+          continue;
         }
-      } else {
-        DWORD error = GetLastError();
-        qWarning(
-            qUtf8Printable(QString("Unable to get file attributes for %1 (error %2)")
-                               .arg(path)
-                               .arg(error)));
+
+        QString source = provider.mod.toHtmlEscaped();
+        if (!provider.masters.isEmpty()) {
+          source +=
+              " " +
+              tr("(requires %1)").arg(provider.masters.join(", ").toHtmlEscaped());
+        }
+        mods.append(source);
+      }
+      if (!mods.isEmpty()) {
+        sources[master] = mods.join("<br>");
       }
     }
-  } else {
-    DWORD error = GetLastError();
-    qWarning(qUtf8Printable(QString("Unable to get file attributes for %1 (error %2)")
-                                .arg(path)
-                                .arg(error)));
-    success = false;
   }
 
-  return success;
+  std::scoped_lock lock(m_Mutex);
+  m_PluginProblems = std::move(problems);
+  m_MasterSources  = std::move(sources);
+  return !m_PluginProblems.empty();
+}
+
+bool DiagnoseBasic::alternateGame(const CheckInput& input) const
+{
+  const ModSnapshot& mods = *input.mods;
+  return std::any_of(
+      mods.mods().begin(), mods.mods().end(), [](const ModSnapshot::Mod& mod) {
+        return mod.isActive() && mod.state.testFlag(IModList::STATE_ALTERNATE);
+      });
+}
+
+bool DiagnoseBasic::invalidFontConfig(const CheckInput& input) const
+{
+  if (!input.fontGame) {
+    // this check is only for skyrim
+    return false;
+  }
+
+  if (input.fontConfigPath.isEmpty()) {
+    std::scoped_lock lock(m_Mutex);
+    m_FontProblems.clear();
+    return false;
+  }
+
+  // read along with the input, only parsed again when the file changed
+  if (!input.fontConfig) {
+    qDebug("failed to open %s", qUtf8Printable(input.fontConfigPath));
+    return false;
+  }
+
+  const FontConfig& fonts = *input.fontConfig;
+  std::vector<FontProblem> problems;
+
+  for (const auto& malformed : fonts.malformed()) {
+    problems.push_back(
+        {malformed.line,
+         tr("<code>%1</code> cannot be parsed").arg(malformed.text.toHtmlEscaped())});
+  }
+
+  // files from skyrim_interface.bsa are not part of the virtual file system
+  static const QSet<QString> defaultFonts{"interface\\fonts_console.swf",
+                                          "interface\\fonts_en.swf",
+                                          "interface\\fonts_cclub.swf"};
+
+  for (const auto& library : fonts.libraries()) {
+    if (!defaultFonts.contains(QString(library.path).replace('/', '\\').toLower()) &&
+        !input.installedFonts.contains(library.path)) {
+      problems.push_back({library.line, tr("font library <code>%1</code> is not "
+                                           "installed")
+                                            .arg(library.path.toHtmlEscaped())});
+    }
+  }
+
+  QSet<QString> aliases;
+  for (const auto& mapping : fonts.mappings()) {
+    aliases.insert(mapping.alias);
+  }
+
+  for (const auto& nameChars : fonts.nameChars()) {
+    if (!aliases.contains(nameChars.alias)) {
+      problems.push_back({nameChars.line, tr("<code>%1</code> is not mapped to a font")
+                                              .arg(nameChars.alias.toHtmlEscaped())});
+    }
+  }
+
+  std::stable_sort(problems.begin(), problems.end(),
+                   [](const FontProblem& lhs, const FontProblem& rhs) {
+                     return lhs.line < rhs.line;
+                   });
+
+  std::scoped_lock lock(m_Mutex);
+  m_FontProblems = std::move(problems);
+  return !m_FontProblems.empty();
+}
+
+// runs the given work on a worker thread while the progress dialog stays responsive,
+// the work reports its progress through the given counters
+static void runWithProgress(QProgressDialog& dialog, const std::atomic<int>& value,
+                            const std::atomic<int>& maximum,
+                            const std::function<void()>& work)
+{
+  QEventLoop loop;
+  QTimer timer;
+  QObject::connect(&timer, &QTimer::timeout, [&]() {
+    dialog.setMaximum(std::max(maximum.load(), 1));
+    dialog.setValue(std::min(value.load(), dialog.maximum()));
+  });
+  timer.start(100);
+
+  QThreadPool::globalInstance()->start([&]() {
+    work();
+    QMetaObject::invokeMethod(&loop, &QEventLoop::quit, Qt::QueuedConnection);
+  });
+  loop.exec();
 }
 
 bool DiagnoseBasic::fileAttributes(const QString& executable) const
 {
-  if (!m_MOInfo->pluginSetting(name(), "check_fileattributes").toBool())
+  if (!currentSettings().checkFileAttributes)
     return true;
 
   QStringList filesToFix;
@@ -516,24 +839,14 @@ bool DiagnoseBasic::fileAttributes(const QString& executable) const
   directoriesToSearch << m_MOInfo->managedGame()->dataDirectory().absolutePath();
 
   // Find the active mods to search them too
-  for (QString mod : m_MOInfo->modList()->allMods()) {
-    if (m_MOInfo->modList()->state(mod) & MOBase::IModList::STATE_ACTIVE) {
-      directoriesToSearch << m_MOInfo->modList()->getMod(mod)->absolutePath();
-    }
-  }
-
-  // Find the subdirectories of all the directories
-  for (int i = 0; i < directoriesToSearch.length(); i++) {
-    for (QString dir :
-         QDir(directoriesToSearch[i])
-             .entryList(QDir::Hidden | QDir::AllDirs | QDir::NoDotAndDotDot)) {
-      directoriesToSearch << directoriesToSearch[i] + "\\" + dir;
+  for (const ModSnapshot::Mod& mod : modSnapshot()->mods()) {
+    if (mod.isActive() && !mod.path.isEmpty()) {
+      directoriesToSearch << mod.path;
     }
   }
 
   // Set up a progress bar since this can take a while
   QPushButton* progressButton = new QPushButton("Cancel");
-  progressButton->setEnabled(false);
 
   QLabel* progressLabel = new QLabel;
   progressLabel->setText(tr("File attribute checker\nSearching for problems..."));
@@ -544,26 +857,38 @@ bool DiagnoseBasic::fileAttributes(const QString& executable) const
   dialog.setCancelButton(progressButton);
   dialog.setLabel(progressLabel);
   dialog.setMinimumDuration(1);
+  dialog.setAutoClose(false);
+  dialog.setAutoReset(false);
   dialog.show();
-  dialog.setMaximum(directoriesToSearch.length());
 
-  // Find problems with the directories and files
-  for (int i = 0; i < directoriesToSearch.length(); i++) {
-    QString* dirPath  = &directoriesToSearch[i];
-    QString fixedPath = QString("\\\\?\\%1").arg(QDir::toNativeSeparators(*dirPath));
-    if (checkFileAttributes(fixedPath))
-      filesToFix << fixedPath;
+  std::unique_ptr<AttributeBackend> backend = AttributeBackend::create();
+  AttributeScanner scanner(*backend);
+  QObject::connect(&dialog, &QProgressDialog::canceled, [&]() {
+    scanner.cancel();
+  });
 
-    for (QString file : QDir(*dirPath).entryList(QDir::Hidden | QDir::AllEntries |
-                                                 QDir::NoDotAndDotDot)) {
-      fixedPath =
-          QString("\\\\?\\%1").arg(QDir::toNativeSeparators(*dirPath + "\\" + file));
-      if (checkFileAttributes(fixedPath))
-        filesToFix << fixedPath;
-    }
-    dialog.setValue(i);
+  // Directories that were clean during the last scan and have not changed since are
+  // not listed again
+  const QString cachePath = QDir(m_MOInfo->basePath()).filePath(ATTRIBUTE_CACHE);
+  AttributeCache cache;
+  cache.load(cachePath);
+
+  // Find problems with the directories and files, the subdirectories are walked
+  // in parallel
+  runWithProgress(dialog, scanner.scanned(), scanner.discovered(), [&]() {
+    filesToFix = scanner.scan(directoriesToSearch, cache);
+  });
+
+  if (scanner.isCanceled()) {
+    qDebug() << "User canceled the file attribute check";
+    return true;
   }
 
+  qDebug() << QString("File attribute check visited %1 directories, %2 were unchanged")
+                  .arg(scanner.scanned().load())
+                  .arg(scanner.skipped());
+  cache.save(cachePath);
+
   if (filesToFix.length() == 0) {
     return true;
   }
@@ -585,58 +910,337 @@ bool DiagnoseBasic::fileAttributes(const QString& executable) const
 
   // Reset progress bar
   progressLabel->setText(tr("File attribute checker\nFixing file attributes..."));
+  progressButton->setEnabled(false);
   dialog.setValue(0);
-  dialog.setMaximum(filesToFix.length());
-
-  // Start iterating through files fixing problems
-  bool success = true;
-  for (int i = 0; i < filesToFix.length(); i++) {
-    if (!fixFileAttributes(filesToFix[i]))
-      success = false;
-    dialog.setValue(i);
-  }
-
-  if (!success) {
-    if (QMessageBox::question(nullptr, tr("Unable to set file attributes"),
-                              tr("Mod Organizer was unable to fix the file attributes "
-                                 "of at least one file.\n\n"
-                                 "Continue launching %1?")
-                                  .arg(executable),
-                              QMessageBox::Yes | QMessageBox::No) == QMessageBox::No) {
-      return false;
+
+  // Fix the files in parallel, every change is logged so it can be undone
+  const QString logPath = QDir(m_MOInfo->basePath()).filePath(ATTRIBUTE_LOG);
+  AttributeRepairer repairer(*backend, logPath);
+  QStringList failed;
+  runWithProgress(dialog, repairer.processed(), repairer.total(), [&]() {
+    failed = repairer.repair(filesToFix);
+  });
+
+  // the changes can be undone whatever the outcome, which cancels the launch
+  const auto undo = [&]() {
+    // restore the original attributes of every file that was changed
+    if (!repairer.rollback(repairer.session())) {
+      QMessageBox::warning(nullptr, tr("Unable to undo changes"),
+                           tr("Some file attributes could not be restored, see "
+                              "%1 for the list of changes.")
+                               .arg(QDir::toNativeSeparators(logPath)));
     }
+    return false;
+  };
+
+  if (failed.isEmpty()) {
+    QMessageBox box(QMessageBox::Information, tr("File attributes fixed"),
+                    tr("The file attributes of %n file(s) have been fixed.\n\n"
+                       "Undo Changes restores the original attributes of every "
+                       "file and cancels the launch.",
+                       "", static_cast<int>(filesToFix.size())),
+                    QMessageBox::Ok);
+    QPushButton* undoButton = box.addButton(tr("Undo Changes"), QMessageBox::ResetRole);
+    box.exec();
+
+    return box.clickedButton() == undoButton ? undo() : true;
   }
 
-  return true;
+  QMessageBox box(QMessageBox::Question, tr("Unable to set file attributes"),
+                  tr("Mod Organizer was unable to fix the file attributes "
+                     "of %n file(s).\n\n"
+                     "Continue launching %1? Undo Changes restores the original "
+                     "attributes of every file and cancels the launch.",
+                     "", static_cast<int>(failed.size()))
+                      .arg(executable),
+                  QMessageBox::Yes | QMessageBox::No);
+  box.setDetailedText(failed.join("\n"));
+  QPushButton* undoButton = box.addButton(tr("Undo Changes"), QMessageBox::ResetRole);
+  box.exec();
+
+  if (box.clickedButton() == undoButton) {
+    return undo();
+  }
+
+  return box.clickedButton() == box.button(QMessageBox::Yes);
 }
 
-std::vector<unsigned int> DiagnoseBasic::activeProblems() const
+std::shared_ptr<const ModSnapshot> DiagnoseBasic::modSnapshot() const
 {
-  std::vector<unsigned int> result;
+  std::scoped_lock lock(m_ModsMutex);
+  if (!m_Mods) {
+    m_Mods = std::make_shared<const ModSnapshot>(*m_MOInfo->modList());
+  } else {
+    CheckMetrics::addCacheHit();
+  }
+  return m_Mods;
+}
+
+void DiagnoseBasic::invalidateMods()
+{
+  {
+    std::scoped_lock lock(m_ModsMutex);
+    m_Mods.reset();
+  }
+
+  std::scoped_lock lock(m_ProvidersMutex);
+  m_Providers.reset();
+  m_ProvidersMods.reset();
+}
+
+std::shared_ptr<const PluginProviders>
+DiagnoseBasic::pluginProviders(const std::shared_ptr<const ModSnapshot>& mods) const
+{
+  // the index is rebuilt when the snapshot was replaced since
+  std::scoped_lock lock(m_ProvidersMutex);
+  if (!m_Providers || m_ProvidersMods != mods) {
+    m_Providers = std::make_shared<const PluginProviders>(PluginProviders::scan(*mods));
+    m_ProvidersMods = mods;
+    CheckMetrics::addFiles(m_Providers->size());
+  } else {
+    CheckMetrics::addCacheHit();
+  }
+  return m_Providers;
+}
+
+void DiagnoseBasic::invalidateChecks(std::initializer_list<unsigned int> keys) const
+{
+  {
+    std::scoped_lock lock(m_ChecksMutex);
+    for (unsigned int key : keys) {
+      CheckState& state = m_Checks[key];
+      state.dirty       = true;
+      state.restart     = m_Scheduler.isRunning(key);
+    }
+  }
+
+  // a guided fix notifies once when it is done
+  if (!m_Batching) {
+    m_NotifyInvalidated();
+  }
+}
+
+void DiagnoseBasic::invalidateAllChecks() const
+{
+  {
+    std::scoped_lock lock(m_ChecksMutex);
+    for (auto& [key, state] : m_Checks) {
+      state.dirty   = true;
+      state.restart = m_Scheduler.isRunning(key);
+    }
+  }
+  m_NotifyInvalidated();
+}
+
+const std::vector<DiagnoseBasic::CheckDefinition>& DiagnoseBasic::checks()
+{
+  // the order of this list is the order in which problems are reported
+  static const std::vector<CheckDefinition> definitions{
+      {PROBLEM_ERRORLOG, "errorlog", &Settings::checkErrorLog,
+       &DiagnoseBasic::errorReported, false},
+      {PROBLEM_OVERWRITE, "overwrite", &Settings::checkOverwrite,
+       &DiagnoseBasic::overwriteFiles, true},
+      {PROBLEM_INVALIDFONT, "font", &Settings::checkFont,
+       &DiagnoseBasic::invalidFontConfig, true},
+      {PROBLEM_NITPICKINSTALLED, "conflict", &Settings::checkConflict,
+       &DiagnoseBasic::nitpickInstalled, true},
+      {PROBLEM_ASSETORDER, "assetorder", &Settings::checkAssetOrder,
+       &DiagnoseBasic::assetOrder, true},
+      {PROBLEM_MISSINGMASTERS, "missingmasters", &Settings::checkMissingMasters,
+       &DiagnoseBasic::missingMasters, true},
+      {PROBLEM_ALTERNATE, "alternategames", &Settings::checkAlternateGames,
+       &DiagnoseBasic::alternateGame, true},
+      {PROBLEM_PROFILETWEAKS, "profiletweaks", nullptr, &DiagnoseBasic::profileTweaks,
+       false},
+      {PROBLEM_PERFORMANCE, "timings", &Settings::showCheckTimings,
+       &DiagnoseBasic::checkTimings, false}};
+
+  return definitions;
+}
+
+DiagnoseBasic::Settings DiagnoseBasic::currentSettings() const
+{
+  std::scoped_lock lock(m_SettingsMutex);
+  if (!m_Settings) {
+    auto setting = [this](const char* key) {
+      return m_MOInfo->pluginSetting(name(), key).toBool();
+    };
+
+    m_Settings =
+        Settings{setting("check_errorlog"),       setting("check_overwrite"),
+                 setting("check_font"),           setting("check_conflict"),
+                 setting("check_assetorder"),     setting("check_missingmasters"),
+                 setting("check_alternategames"), setting("check_fileattributes"),
+                 setting("async_checks"),         setting("log_include_warnings"),
+                 setting("ow_ignore_empty"),      setting("ow_ignore_log"),
+                 setting("show_check_timings")};
+  }
+  return *m_Settings;
+}
 
-  if (m_MOInfo->pluginSetting(name(), "check_errorlog").toBool() && errorReported()) {
-    result.push_back(PROBLEM_ERRORLOG);
+std::shared_ptr<const DiagnoseBasic::CheckInput>
+DiagnoseBasic::checkInput(const std::set<unsigned int>& keys) const
+{
+  auto input = std::make_shared<CheckInput>();
+  if (keys.empty()) {
+    return input;
   }
-  if (m_MOInfo->pluginSetting(name(), "check_overwrite").toBool() && overwriteFiles()) {
-    result.push_back(PROBLEM_OVERWRITE);
+
+  input->settings      = currentSettings();
+  input->dataPath      = qApp->property("dataPath").toString();
+  input->overwritePath = m_MOInfo->overwritePath();
+  input->profilePath   = m_MOInfo->profilePath();
+
+  const IPluginGame* game = m_MOInfo->managedGame();
+  if (keys.contains(PROBLEM_OVERWRITE)) {
+    CheckMetrics::InputScope scope(input->times, keys, {PROBLEM_OVERWRITE});
+    input->modMappings = game->getModMappings().keys();
   }
-  if (m_MOInfo->pluginSetting(name(), "check_font").toBool() && invalidFontConfig()) {
-    result.push_back(PROBLEM_INVALIDFONT);
+
+  if (keys.contains(PROBLEM_INVALIDFONT)) {
+    CheckMetrics::InputScope scope(input->times, keys, {PROBLEM_INVALIDFONT});
+    input->fontGame =
+        game->gameName() == "Skyrim" || game->gameShortName() == "SkyrimSE";
+    if (input->fontGame) {
+      input->fontConfigPath = m_MOInfo->resolvePath("interface/fontconfig.txt");
+    }
+
+    // a configuration lists a handful of libraries, so they are resolved one by one
+    if (!input->fontConfigPath.isEmpty()) {
+      input->fontConfig = m_FontConfigs.get(input->fontConfigPath);
+    }
+    if (input->fontConfig) {
+      for (const auto& library : input->fontConfig->libraries()) {
+        if (!m_MOInfo->resolvePath(library.path).isEmpty()) {
+          input->installedFonts.insert(library.path);
+        }
+      }
+    }
   }
-  if (m_MOInfo->pluginSetting(name(), "check_conflict").toBool() &&
-      nitpickInstalled()) {
-    result.push_back(PROBLEM_NITPICKINSTALLED);
+
+  if (keys.contains(PROBLEM_NITPICKINSTALLED)) {
+    CheckMetrics::InputScope scope(input->times, keys, {PROBLEM_NITPICKINSTALLED});
+    input->nitpickInstalled =
+        !m_MOInfo->resolvePath("skse/plugins/nitpick.dll").isEmpty();
   }
-  if (m_MOInfo->pluginSetting(name(), "check_missingmasters").toBool() &&
-      missingMasters()) {
-    result.push_back(PROBLEM_MISSINGMASTERS);
+
+  if (keys.contains(PROBLEM_ASSETORDER) || keys.contains(PROBLEM_MISSINGMASTERS) ||
+      keys.contains(PROBLEM_ALTERNATE)) {
+    CheckMetrics::InputScope scope(
+        input->times, keys,
+        {PROBLEM_ASSETORDER, PROBLEM_MISSINGMASTERS, PROBLEM_ALTERNATE});
+    input->mods = modSnapshot();
   }
-  if (m_MOInfo->pluginSetting(name(), "check_alternategames").toBool() &&
-      alternateGame()) {
-    result.push_back(PROBLEM_ALTERNATE);
+
+  if (keys.contains(PROBLEM_MISSINGMASTERS)) {
+    CheckMetrics::InputScope scope(input->times, keys, {PROBLEM_MISSINGMASTERS});
+    input->pluginGraphReused = m_PluginGraph.isBuilt();
+    if (!input->pluginGraphReused) {
+      m_PluginGraph.rebuild(m_MOInfo->pluginList());
+    }
   }
-  if (QFile::exists(m_MOInfo->profilePath() + "/profile_tweaks.ini")) {
-    result.push_back(PROBLEM_PROFILETWEAKS);
+
+  if (keys.contains(PROBLEM_ASSETORDER)) {
+    CheckMetrics::InputScope scope(input->times, keys, {PROBLEM_ASSETORDER});
+    IPluginList* plugins = m_MOInfo->pluginList();
+    for (const QString& esp : plugins->pluginNames()) {
+      if (plugins->state(esp) != IPluginList::STATE_ACTIVE) {
+        continue;
+      }
+
+      // plugins from the game directory have no mod
+      const QString modName       = plugins->origin(esp);
+      const ModSnapshot::Mod* mod = input->mods->find(modName);
+      if (mod == nullptr || mod->path.isEmpty()) {
+        continue;
+      }
+
+      input->assetPlugins.push_back(ListElement{esp, modName, plugins->priority(esp),
+                                                mod->priority, -1,
+                                                plugins->isMasterFlagged(esp)});
+    }
+  }
+
+  return input;
+}
+
+std::vector<unsigned int> DiagnoseBasic::activeProblems() const
+{
+  const Settings current = currentSettings();
+
+  std::vector<const CheckDefinition*> enabled;
+  for (const CheckDefinition& definition : checks()) {
+    if (definition.setting == nullptr || current.*definition.setting) {
+      enabled.push_back(&definition);
+    }
+  }
+
+  // in asynchronous mode, this only collects the checks that have finished and the
+  // list is refreshed again once the others are done
+  const bool async = current.asyncChecks;
+
+  // the checks are independent of each other, so every outdated one is started on
+  // the worker pool at once; uncached checks whose result was just published are
+  // not restarted so that publishing a result does not trigger yet another pass
+  //
+  // the overwrite result is only kept while the watcher reports every change, it is
+  // walked again on every pass otherwise
+  const bool overwriteTracked = m_OverwriteWatcher.isTracking();
+  {
+    std::scoped_lock lock(m_ChecksMutex);
+    std::vector<const CheckDefinition*> outdated;
+    std::set<unsigned int> keys;
+    for (const CheckDefinition* definition : enabled) {
+      CheckState& state = m_Checks[definition->key];
+      const bool cached = definition->cached &&
+                          (definition->key != PROBLEM_OVERWRITE || overwriteTracked);
+      if (!cached && !state.published) {
+        state.dirty = true;
+      }
+      state.published = false;
+      if (state.dirty && !m_Scheduler.isRunning(definition->key)) {
+        outdated.push_back(definition);
+        keys.insert(definition->key);
+      }
+    }
+
+    // the input is read while the lock is held, so a change made in the meantime
+    // marks the checks for a restart
+    const std::shared_ptr<const CheckInput> input = checkInput(keys);
+    for (const CheckDefinition* definition : outdated) {
+      m_Scheduler.start(definition->key, [this, definition, input]() {
+        // the timings check only shows the runs of the others and is not measured
+        if (definition->key == PROBLEM_PERFORMANCE) {
+          return (this->*definition->check)(*input);
+        }
+
+        CheckMetrics::Scope scope(m_Metrics, definition->key, definition->name);
+        scope.addInput(input->times);
+        return scope.finish((this->*definition->check)(*input));
+      });
+    }
+  }
+
+  // the lock is not held while waiting so that the callbacks are not blocked
+  const auto timeout = async ? std::chrono::milliseconds(0) : CHECK_TIMEOUT;
+  const std::map<unsigned int, bool> finished = m_Scheduler.wait(timeout);
+
+  std::scoped_lock lock(m_ChecksMutex);
+  for (auto [key, active] : finished) {
+    CheckState& state = m_Checks[key];
+    state.active      = active;
+    state.dirty       = state.restart;
+    state.restart     = false;
+    state.published   = async;
+  }
+
+  // checks that timed out report their previous result and are picked up again on
+  // the next pass
+  std::vector<unsigned int> result;
+  for (const CheckDefinition* definition : enabled) {
+    if (m_Checks[definition->key].active) {
+      result.push_back(definition->key);
+    }
   }
 
   return result;
@@ -653,24 +1257,127 @@ QString DiagnoseBasic::shortDescription(unsigned int key) const
     return tr("Your font configuration may be broken");
   case PROBLEM_NITPICKINSTALLED:
     return tr("Nitpick installed");
+  case PROBLEM_ASSETORDER:
+    return tr("Plugin load order does not match the mod order of their scripts");
   case PROBLEM_PROFILETWEAKS:
     return tr("INI Tweaks overwritten");
   case PROBLEM_MISSINGMASTERS:
     return tr("Missing Masters");
   case PROBLEM_ALTERNATE:
     return tr("At least one unverified mod is using an alternative game source");
+  case PROBLEM_PERFORMANCE:
+    return tr("Timings of the recent checks");
   default:
     throw MyException(tr("invalid problem key %1").arg(key));
   }
 }
 
+QString DiagnoseBasic::overwriteSummary() const
+{
+  // built by the check, there is none until it has found content
+  std::shared_ptr<const OverwriteSummary> summary;
+  {
+    std::scoped_lock lock(m_Mutex);
+    summary = m_OverwriteSummary;
+  }
+  if (!summary) {
+    return {};
+  }
+
+  const auto groupTable = [](const QString& title,
+                             const std::vector<OverwriteSummary::Group>& groups) {
+    QString rows;
+    for (const OverwriteSummary::Group& group : groups) {
+      rows += "<tr>";
+      rows += "<td style=\"padding-left: 20px\">" +
+              (group.name.isEmpty() ? tr("(none)") : group.name.toHtmlEscaped()) +
+              "</td>";
+      rows +=
+          "<td style=\"padding-left: 20px\">" + QString::number(group.files) + "</td>";
+      rows += "<td style=\"padding-left: 20px\">" +
+              QLocale().formattedDataSize(group.bytes) + "</td>";
+      rows += "<td style=\"padding-left: 20px\">" +
+              QLocale().toString(group.oldest, QLocale::ShortFormat) + "</td>";
+      rows += "<td style=\"padding-left: 20px\">" +
+              QLocale().toString(group.newest, QLocale::ShortFormat) + "</td>";
+      rows += "<td style=\"padding-left: 20px\">" + group.tool + "</td>";
+      rows += "</tr>";
+    }
+
+    QString header;
+    for (const QString& column : {title, tr("Files"), tr("Size"), tr("Oldest"),
+                                  tr("Newest"), tr("Likely created by")}) {
+      header +=
+          "<th style=\"padding-left: 20px; text-align: left\">" + column + "</th>";
+    }
+
+    return "<table><tr>" + header + "</tr>" + rows + "</table>";
+  };
+
+  const OverwriteSummary::Group& total = summary->total();
+  if (total.files == 0) {
+    return {};
+  }
+
+  const QString totals =
+      summary->complete()
+          ? tr("<i>Overwrite</i> holds %1 files for a total of %2.")
+          : tr("<i>Overwrite</i> holds more than %1 files, the first of which total "
+               "%2. Only those are listed below.");
+
+  return "<hr>" +
+         totals.arg(total.files).arg(QLocale().formattedDataSize(total.bytes)) +
+         "<br>" + groupTable(tr("Directory"), summary->directories()) + "<br>" +
+         groupTable(tr("Extension"), summary->extensions());
+}
+
+QString DiagnoseBasic::checkTimingsTable() const
+{
+  QString header;
+  for (const QString& column :
+       {tr("Finished"), tr("Check"), tr("Result"), tr("Time"), tr("Input"), tr("Files"),
+        tr("Read"), tr("Cache hits")}) {
+    header += "<th style=\"padding-left: 20px; text-align: left\">" + column + "</th>";
+  }
+
+  // most recent first
+  const std::vector<CheckRun> runs = m_Metrics.history();
+  QString rows;
+  for (auto it = runs.rbegin(); it != runs.rend(); ++it) {
+    const double milliseconds      = it->duration.count() / 1000.0;
+    const double inputMilliseconds = it->input.count() / 1000.0;
+
+    rows += "<tr>";
+    rows += "<td style=\"padding-left: 20px\">" +
+            QLocale().toString(it->finished.time(), "HH:mm:ss.zzz") + "</td>";
+    rows += "<td style=\"padding-left: 20px\">" + QString(it->name) + "</td>";
+    rows += "<td style=\"padding-left: 20px\">" +
+            (it->active ? tr("problem") : tr("ok")) + "</td>";
+    rows += "<td style=\"padding-left: 20px\">" +
+            tr("%1 ms").arg(QLocale().toString(milliseconds, 'f', 1)) + "</td>";
+    rows += "<td style=\"padding-left: 20px\">" +
+            tr("%1 ms").arg(QLocale().toString(inputMilliseconds, 'f', 1)) + "</td>";
+    rows +=
+        "<td style=\"padding-left: 20px\">" + QLocale().toString(it->files) + "</td>";
+    rows += "<td style=\"padding-left: 20px\">" +
+            QLocale().formattedDataSize(static_cast<qint64>(it->bytes)) + "</td>";
+    rows += "<td style=\"padding-left: 20px\">" + QLocale().toString(it->cacheHits) +
+            "</td>";
+    rows += "</tr>";
+  }
+
+  return "<hr><table><tr>" + header + "</tr>" + rows + "</table>";
+}
+
 QString DiagnoseBasic::fullDescription(unsigned int key) const
 {
   switch (key) {
-  case PROBLEM_ERRORLOG:
-    return "<code>" + m_ErrorMessage.replace("\n", "<br>") + "</code>";
-  case PROBLEM_OVERWRITE:
-    return tr(
+  case PROBLEM_ERRORLOG: {
+    std::scoped_lock lock(m_Mutex);
+    return m_ErrorMessage;
+  }
+  case PROBLEM_OVERWRITE: {
+    const QString description = tr(
         "There are currently files in your <span style=\"color: "
         "red;\"><i>Overwrite</i></span> directory. These files are typically newly "
         "created files, usually generated by an external mod tool (i.e. Wrye Bash, "
@@ -701,18 +1408,51 @@ QString DiagnoseBasic::fullDescription(unsigned int key) const
         "<span style=\"font-weight: bold;\">Overwrite</span> directory, you can open "
         "the Mod Organizer settings and disable this warning under the \"Diagnose "
         "Basic\" plugin configuration.");
-  case PROBLEM_INVALIDFONT:
-    return tr("Your current configuration seems to reference a font that is not "
-              "installed. You may see only boxes instead of letters.<br>"
-              "The font configuration is in Data\\interface\\fontconfig.txt. Most "
-              "likely you have a broken installation of a font replacer mod.");
+    return description + overwriteSummary();
+  }
+  case PROBLEM_INVALIDFONT: {
+    QString result =
+        tr("Your current configuration seems to reference a font that is not "
+           "installed. You may see only boxes instead of letters.<br>"
+           "The font configuration is in Data\\interface\\fontconfig.txt. Most "
+           "likely you have a broken installation of a font replacer mod.");
+
+    std::scoped_lock lock(m_Mutex);
+    if (!m_FontProblems.empty()) {
+      result += "<ul>";
+      for (const FontProblem& problem : m_FontProblems) {
+        const QString line = QString::number(problem.line);
+        result += "<li>" + tr("Line %1: %2").arg(line, problem.message) + "</li>";
+      }
+      result += "</ul>";
+    }
+    return result;
+  }
   case PROBLEM_NITPICKINSTALLED:
     return tr("You have the nitpick skse plugin installed. This plugin is not needed "
               "with Mod Organizer because MO already offers the same functionality. "
               "Worse: The two solutions may conflict so it's strongly suggested you "
               "remove this plugin.");
+  case PROBLEM_ASSETORDER: {
+    std::scoped_lock lock(m_Mutex);
+    QString moveInfo;
+    for (const Move& move : m_AssetMoves) {
+      moveInfo += "<li>" +
+                  (move.type == Move::AFTER ? tr("Move <b>%1</b> after <b>%2</b>")
+                                            : tr("Move <b>%1</b> before <b>%2</b>"))
+                      .arg(move.item, move.reference) +
+                  "</li>";
+    }
+    return tr("Some mods pack the same scripts in their archives. Archives are "
+              "loaded according to the plugin load order, so a script from a mod of "
+              "lower priority is used although the mod list shows the other mod as "
+              "the winner of the conflict.<br>"
+              "Reordering the following plugins makes both orders agree:") +
+           "<ul>" + moveInfo + "</ul>";
+  } break;
   case PROBLEM_PROFILETWEAKS: {
-    QString fileContent = readFileText(m_MOInfo->profilePath() + "/profile_tweaks.ini");
+    std::shared_ptr<const QString> fileContent =
+        m_ProfileTweaks.get(QDir(m_MOInfo->profilePath()).filePath(PROFILE_TWEAKS));
     return tr("Settings provided in ini tweaks have been overwritten in-game or in an "
               "applications.<br>"
               "These overwrites are stored in a separate file "
@@ -723,24 +1463,68 @@ QString DiagnoseBasic::fullDescription(unsigned int key) const
               "Advice: Copy settings you want to keep to an appropriate ini tweak, "
               "then delete <i>profile_tweaks.ini</i>.<br>"
               "Hitting the <i>Fix</i> button will delete that file") +
-           "<hr><i>profile_tweaks.ini:</i><pre>" + fileContent + "</pre>";
+           "<hr><i>profile_tweaks.ini:</i><pre>" +
+           (fileContent ? fileContent->toHtmlEscaped() : QString()) + "</pre>";
   } break;
   case PROBLEM_MISSINGMASTERS: {
-    QString masterInfo;
-    for (auto master : m_MissingMasters) {
-      masterInfo += "<tr>";
-      masterInfo += "<td style=\"padding-left: 20px\">" + master + "</td>";
-      masterInfo += "<td style=\"padding-left: 20px\">" +
-                    SetJoin(m_PluginChildren[master], ", ") + "</td>";
-      masterInfo += "</tr>";
-    }
-    return tr("The masters for some plugins (esp/esl/esm) are not enabled.<br>"
-              "The game will crash unless you install and enable the following "
-              "plugins: ") +
-           "<br/><table><tr>" + "<th style=\"padding-left: 20px; text-align: left\">" +
-           tr("Master") + "</th>" +
-           "<th style=\"padding-left: 20px; text-align: left\">" + tr("Required By") +
-           "</th></tr>" + masterInfo + "</table>";
+    std::scoped_lock lock(m_Mutex);
+
+    const auto table = [](const QStringList& header,
+                          const std::vector<QStringList>& rows) {
+      QString result = "<br/><table><tr>";
+      for (const QString& column : header) {
+        result +=
+            "<th style=\"padding-left: 20px; text-align: left\">" + column + "</th>";
+      }
+      result += "</tr>";
+      for (const QStringList& row : rows) {
+        result += "<tr>";
+        for (const QString& cell : row) {
+          result += "<td style=\"padding-left: 20px\">" + cell + "</td>";
+        }
+        result += "</tr>";
+      }
+      return result + "</table>";
+    };
+
+    const auto childRows = [](const std::map<QString, std::set<QString>>& masters) {
+      std::vector<QStringList> rows;
+      for (const auto& [master, children] : masters) {
+        rows.push_back({master, SetJoin(children, ", ")});
+      }
+      return rows;
+    };
+
+    QString result;
+    if (!m_PluginProblems.missing.empty()) {
+      std::vector<QStringList> rows = childRows(m_PluginProblems.missing);
+      for (QStringList& row : rows) {
+        auto source = m_MasterSources.find(row.front());
+        row.append(source != m_MasterSources.end() ? source->second : QString("-"));
+      }
+      result += tr("The masters for some plugins (esp/esl/esm) are not enabled.<br>"
+                   "The game will crash unless you install and enable the following "
+                   "plugins. Disabled mods shipping them are listed as well: ") +
+                table({tr("Master"), tr("Required By"), tr("Available In")}, rows);
+    }
+    if (!m_PluginProblems.late.empty()) {
+      result +=
+          "<br>" +
+          tr("Some masters load after plugins that require them. Masters have "
+             "to load before every plugin requiring them: ") +
+          table({tr("Master"), tr("Loaded After")}, childRows(m_PluginProblems.late));
+    }
+    if (!m_PluginProblems.broken.empty()) {
+      std::vector<QStringList> rows;
+      for (const auto& [plugin, master] : m_PluginProblems.broken) {
+        rows.push_back({plugin, master});
+      }
+      result += "<br>" +
+                tr("The following plugins have all their masters in order, but "
+                   "require a plugin that has a problem itself: ") +
+                table({tr("Plugin"), tr("Requires")}, rows);
+    }
+    return result;
   } break;
   case PROBLEM_ALTERNATE: {
     return tr(
@@ -755,6 +1539,14 @@ QString DiagnoseBasic::fullDescription(unsigned int key) const
         "context menu<br>"
         "and select \"Mark as converted/working\" to remove the flag and warning.");
   } break;
+  case PROBLEM_PERFORMANCE: {
+    return tr("This entry is shown because check timings are enabled in the settings "
+              "of the plugin. The time is the wall time of the check, input is the "
+              "time spent gathering what the check reads before it starts, files "
+              "counts the files walked on disk or in the virtual file system and cache "
+              "hits counts the lookups answered without going to the disk.") +
+           checkTimingsTable();
+  } break;
   default:
     throw MyException(tr("invalid problem key %1").arg(key));
   }
@@ -762,16 +1554,166 @@ QString DiagnoseBasic::fullDescription(unsigned int key) const
 
 bool DiagnoseBasic::hasGuidedFix(unsigned int key) const
 {
-  return (key == PROBLEM_PROFILETWEAKS);
+  return (key == PROBLEM_PROFILETWEAKS) || (key == PROBLEM_MISSINGMASTERS) ||
+         (key == PROBLEM_ASSETORDER);
 }
 
 void DiagnoseBasic::startGuidedFix(unsigned int key) const
 {
   switch (key) {
   case PROBLEM_PROFILETWEAKS: {
-    shellDeleteQuiet(m_MOInfo->profilePath() + "/profile_tweaks.ini");
+    shellDeleteQuiet(QDir(m_MOInfo->profilePath()).filePath(PROFILE_TWEAKS));
+  } break;
+  case PROBLEM_MISSINGMASTERS: {
+    fixMissingMasters();
+  } break;
+  case PROBLEM_ASSETORDER: {
+    fixAssetOrder();
   } break;
   default:
     throw MyException(tr("invalid problem key %1").arg(key));
   }
 }
+
+QStringList DiagnoseBasic::loadOrder() const
+{
+  IPluginList* plugins = m_MOInfo->pluginList();
+
+  std::vector<std::pair<int, QString>> priorities;
+  for (const QString& plugin : plugins->pluginNames()) {
+    priorities.emplace_back(plugins->priority(plugin), plugin);
+  }
+  std::sort(priorities.begin(), priorities.end());
+
+  QStringList order;
+  for (auto& [priority, plugin] : priorities) {
+    order.append(plugin);
+  }
+  return order;
+}
+
+void DiagnoseBasic::beginBatch() const
+{
+  m_Batching = true;
+}
+
+void DiagnoseBasic::endBatch() const
+{
+  m_Batching = false;
+
+  // the callbacks skipped the graph and the notifications while batching
+  m_PluginGraph.rebuild(m_MOInfo->pluginList());
+  invalidateChecks({PROBLEM_MISSINGMASTERS, PROBLEM_ASSETORDER});
+}
+
+void DiagnoseBasic::fixMissingMasters() const
+{
+  IPluginList* plugins = m_MOInfo->pluginList();
+
+  // late masters are moved like missing ones, plugins that only require a broken
+  // plugin are fixed along with it
+  std::map<QString, std::set<QString>> pluginChildren;
+  std::map<QString, QString> sources;
+  {
+    std::scoped_lock lock(m_Mutex);
+    pluginChildren = m_PluginProblems.missing;
+    sources        = m_MasterSources;
+    for (const auto& [master, children] : m_PluginProblems.late) {
+      pluginChildren[master].insert(children.begin(), children.end());
+    }
+  }
+
+  // the load order is rearranged locally and applied at once at the end
+  QStringList order = loadOrder();
+  QStringList notInstalled;
+
+  beginBatch();
+  for (const auto& [master, children] : pluginChildren) {
+    if (plugins->state(master) == IPluginList::STATE_MISSING) {
+      auto source = sources.find(master);
+      notInstalled.append(source != sources.end()
+                              ? tr("%1, available in %2").arg(master, source->second)
+                              : master);
+      continue;
+    }
+    plugins->setState(master, IPluginList::STATE_ACTIVE);
+
+    // masters have to load before the first of their children
+    const qsizetype masterIndex = order.indexOf(master);
+    qsizetype firstChild        = masterIndex;
+    for (const QString& child : children) {
+      const qsizetype childIndex = order.indexOf(child);
+      if (childIndex >= 0 && childIndex < firstChild) {
+        firstChild = childIndex;
+      }
+    }
+    if (masterIndex >= 0 && firstChild < masterIndex) {
+      order.move(masterIndex, firstChild);
+    }
+  }
+
+  if (order != loadOrder()) {
+    plugins->setLoadOrder(order);
+  }
+  endBatch();
+
+  if (!notInstalled.isEmpty()) {
+    QMessageBox::information(nullptr, tr("Missing Masters"),
+                             tr("The following masters are not installed and could "
+                                "not be enabled:<br>%1")
+                                 .arg(notInstalled.join("<br>")));
+  }
+}
+
+void DiagnoseBasic::fixAssetOrder() const
+{
+  std::vector<SortedGroup> groups;
+  {
+    std::scoped_lock lock(m_Mutex);
+    groups = m_AssetGroups;
+  }
+
+  // the plugins of a group that are not kept are taken out of the load order and
+  // inserted again around the kept ones, in the new order of the group
+  QStringList order = loadOrder();
+  for (const SortedGroup& group : groups) {
+    // the group is left alone if one of its plugins disappeared since the check
+    const bool complete = std::all_of(group.plugins.begin(), group.plugins.end(),
+                                      [&](const QString& plugin) {
+                                        return order.contains(plugin);
+                                      });
+    if (!complete) {
+      continue;
+    }
+
+    for (qsizetype i = 0; i < group.plugins.size(); ++i) {
+      if (!group.kept[i]) {
+        order.removeOne(group.plugins[i]);
+      }
+    }
+
+    // plugins ahead of the first kept one are inserted right before it, the others
+    // right after their predecessor in the group
+    QStringList pending;
+    qsizetype position = -1;
+    for (qsizetype i = 0; i < group.plugins.size(); ++i) {
+      const QString& plugin = group.plugins[i];
+      if (group.kept[i]) {
+        position = order.indexOf(plugin);
+        for (const QString& earlier : pending) {
+          order.insert(position++, earlier);
+        }
+        pending.clear();
+        ++position;
+      } else if (position < 0) {
+        pending.append(plugin);
+      } else {
+        order.insert(position++, plugin);
+      }
+    }
+  }
+
+  beginBatch();
+  m_MOInfo->pluginList()->setLoadOrder(order);
+  endBatch();
+}
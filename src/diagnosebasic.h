@@ -24,11 +24,34 @@ along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
 #include <QSet>
 #include <QString>
 
+#include <chrono>
+#include <functional>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <span>
+#include <vector>
+
+#include <uibase/imodinterface.h>
 #include <uibase/imodlist.h>
 #include <uibase/imoinfo.h>
 #include <uibase/iplugin.h>
 #include <uibase/iplugindiagnose.h>
 
+#include "checkmetrics.h"
+#include "checkscheduler.h"
+#include "fontconfig.h"
+#include "logscanner.h"
+#include "modsnapshot.h"
+#include "overwritesummary.h"
+#include "overwritewatcher.h"
+#include "parsedfilecache.h"
+#include "plugingraph.h"
+#include "pluginproviders.h"
+
 class DiagnoseBasic : public QObject,
                       public MOBase::IPlugin,
                       public MOBase::IPluginDiagnose
@@ -59,29 +82,92 @@ public:  // IPluginDiagnose
   virtual void startGuidedFix(unsigned int key) const;
 
 private:
-  bool errorReported() const;
-  bool overwriteFiles() const;
-  bool invalidFontConfig() const;
-  bool nitpickInstalled() const;
-  bool assetOrder() const;
-  bool missingMasters() const;
-  bool alternateGame() const;
+  struct CheckInput;
+
+  bool errorReported(const CheckInput& input) const;
+  bool overwriteFiles(const CheckInput& input) const;
+  bool overwriteContent(const CheckInput& input) const;
+  bool invalidFontConfig(const CheckInput& input) const;
+  bool nitpickInstalled(const CheckInput& input) const;
+  bool assetOrder(const CheckInput& input) const;
+  bool missingMasters(const CheckInput& input) const;
+  bool alternateGame(const CheckInput& input) const;
+  bool profileTweaks(const CheckInput& input) const;
+  bool checkTimings(const CheckInput& input) const;
   bool fileAttributes(const QString& executable) const;
 
+  // reads what the given checks need from the organizer, called before they are
+  // started
+  std::shared_ptr<const CheckInput>
+  checkInput(const std::set<unsigned int>& keys) const;
+
+  // breakdown of the content of the overwrite directory for the description, as
+  // built by the last run of the check
+  QString overwriteSummary() const;
+
+  // table of the recent check runs for the description
+  QString checkTimingsTable() const;
+
+  // state of the mod list shared by the checks, dropped whenever a mod changes
+  std::shared_ptr<const ModSnapshot> modSnapshot() const;
+  void invalidateMods();
+
+  // plugins shipped by every mod, built from the given mod snapshot when a master is
+  // missing and dropped along with it
+  std::shared_ptr<const PluginProviders>
+  pluginProviders(const std::shared_ptr<const ModSnapshot>& mods) const;
+
+  // guided fixes
+  void fixMissingMasters() const;
+  void fixAssetOrder() const;
+
+  // plugin names ordered by priority
+  QStringList loadOrder() const;
+
+  // while batching, changes made to the plugin list by a guided fix only mark the
+  // checks as outdated, the graph is rebuilt and MO is notified once at the end
+  void beginBatch() const;
+  void endBatch() const;
+
+  // marks the given checks as outdated and notifies MO that problems have to be
+  // re-evaluated, also called by the guided fixes
+  void invalidateChecks(std::initializer_list<unsigned int> keys) const;
+  void invalidateAllChecks() const;
+
 private:
-  static const unsigned int PROBLEM_ERRORLOG         = 1;
-  static const unsigned int PROBLEM_OVERWRITE        = 2;
-  static const unsigned int PROBLEM_INVALIDFONT      = 3;
-  static const unsigned int PROBLEM_NITPICKINSTALLED = 4;
-  static const unsigned int PROBLEM_PROFILETWEAKS    = 7;
-  static const unsigned int PROBLEM_MISSINGMASTERS   = 8;
-  static const unsigned int PROBLEM_ALTERNATE        = 9;
+  static constexpr unsigned int PROBLEM_ERRORLOG         = 1;
+  static constexpr unsigned int PROBLEM_OVERWRITE        = 2;
+  static constexpr unsigned int PROBLEM_INVALIDFONT      = 3;
+  static constexpr unsigned int PROBLEM_NITPICKINSTALLED = 4;
+  static constexpr unsigned int PROBLEM_ASSETORDER       = 5;
+  static constexpr unsigned int PROBLEM_PROFILETWEAKS    = 7;
+  static constexpr unsigned int PROBLEM_MISSINGMASTERS   = 8;
+  static constexpr unsigned int PROBLEM_ALTERNATE        = 9;
+  static constexpr unsigned int PROBLEM_PERFORMANCE      = 10;
 
   static const unsigned int NUM_CONTEXT_ROWS = 5;
 
+  // time a single check may take before its result is ignored for the current pass
+  static constexpr std::chrono::milliseconds CHECK_TIMEOUT{30000};
+
   static const QRegularExpression RE_LOG_FILE;
 
+  // file in the instance directory holding the results of the last attribute scan
+  static constexpr const char* ATTRIBUTE_CACHE = "diagnose_basic_attributes.cache";
+
+  static constexpr const char* PROFILE_TWEAKS = "profile_tweaks.ini";
+
+  // file in the instance directory recording every attribute change
+  static constexpr const char* ATTRIBUTE_LOG = "diagnose_basic_repairs.jsonl";
+
 private:
+  // a broken line of the font configuration, the message is html
+  struct FontProblem
+  {
+    int line;
+    QString message;
+  };
+
   struct ListElement
   {
     QString espName;
@@ -93,50 +179,182 @@ private:
     QSet<QString> relevantScripts;
   };
 
+  // moves a plugin relative to another one, only the names are kept so that the
+  // moves stay cheap to copy; the reference is never moved by a later move, so the
+  // moves give the new order when applied in sequence
   struct Move
   {
-    ListElement item;
-    ListElement reference;
+    QString item;
+    QString reference;
     enum EType
     {
       BEFORE,
       AFTER
     } type;
     Move(const ListElement& initItem, const ListElement& initReference, EType initType)
-        : item(initItem), reference(initReference), type(initType)
+        : item(initItem.espName), reference(initReference.espName), type(initType)
     {}
   };
 
+  // new order of a group of plugins sharing scripts, the kept plugins stay where they
+  // are in the load order and the others are placed around them
+  struct SortedGroup
+  {
+    QStringList plugins;
+    std::vector<bool> kept;
+  };
+
   struct Sorter
   {
     struct
     {
-      int operator()(const ListElement& lhs, const ListElement& rhs)
+      bool operator()(const ListElement& lhs, const ListElement& rhs) const
       {
         return lhs.modPriority < rhs.modPriority;
       }
     } minMod;
 
     std::vector<Move> moves;
+    std::vector<SortedGroup> groups;
 
-    void operator()(std::vector<ListElement> modList);
+    // computes the moves and the new order for every group of the list, the list is
+    // reordered by group in place
+    void operator()(std::vector<ListElement>& modList);
 
   private:
-    void sortGroup(std::vector<ListElement> modList);
+    void sortGroup(std::span<ListElement> modList);
   };
 
-  friend bool operator<(const Move& lhs, const Move& rhs);
+  // result of a check and whether it has to be recomputed, restart is set when the
+  // check is invalidated while it is still running so its result is not trusted,
+  // published is set when the result was collected in the background and has not
+  // been reported yet
+  struct CheckState
+  {
+    bool dirty     = true;
+    bool restart   = false;
+    bool published = false;
+    bool active    = false;
+  };
+
+  // typed copy of the plugin settings, read once and dropped whenever one of them
+  // changes so that the checks do not look them up by name
+  struct Settings
+  {
+    bool checkErrorLog;
+    bool checkOverwrite;
+    bool checkFont;
+    bool checkConflict;
+    bool checkAssetOrder;
+    bool checkMissingMasters;
+    bool checkAlternateGames;
+    bool checkFileAttributes;
+    bool asyncChecks;
+    bool logIncludeWarnings;
+    bool ignoreEmpty;
+    bool ignoreLog;
+    bool showCheckTimings;
+  };
+
+  Settings currentSettings() const;
+
+  // what the checks need from the organizer, which is not thread-safe; it is read on
+  // the thread calling activeProblems() and the checks on the worker pool only use
+  // this copy, only the parts needed by the checks being started are filled in
+  struct CheckInput
+  {
+    Settings settings;
+    QString dataPath;
+    QString overwritePath;
+    QString profilePath;
+    QStringList modMappings;
+
+    // the font configuration is only checked for Skyrim, its libraries are looked
+    // up in the virtual file system here
+    bool fontGame = false;
+    QString fontConfigPath;
+    std::shared_ptr<const FontConfig> fontConfig;
+    QSet<QString> installedFonts;
+
+    bool nitpickInstalled = false;
+
+    std::shared_ptr<const ModSnapshot> mods;
+
+    // active plugins provided by a mod, their scripts are listed by the check
+    std::vector<ListElement> assetPlugins;
+
+    // the plugin graph was kept from an earlier pass rather than built for this one
+    bool pluginGraphReused = false;
+
+    // time spent reading the above for each check
+    CheckMetrics::InputTimes times;
+  };
+
+  // a check run by activeProblems(), uncached checks are run on every pass and checks
+  // without a setting are always enabled
+  struct CheckDefinition
+  {
+    unsigned int key;
+
+    // identifies the check in the log
+    const char* name;
+
+    bool Settings::*setting;
+    bool (DiagnoseBasic::*check)(const CheckInput&) const;
+    bool cached;
+  };
+
+  static const std::vector<CheckDefinition>& checks();
 
 private:
-  void topoSort(std::vector<ListElement>& list) const;
-  bool checkEmpty(const QString& path) const;
+  Sorter topoSort(std::vector<ListElement>& list) const;
+  QSet<QString> relevantScripts(const QString& directory, const QStringList& archives,
+                                const QString& plugin) const;
+  bool checkEmpty(const QString& path, bool ignoreLog) const;
 
 private:
   MOBase::IOrganizer* m_MOInfo;
+
+  // guards the results stored by the checks, which run on worker threads
+  mutable std::mutex m_Mutex;
+  mutable LogScanner m_LogScanner;
   mutable QString m_ErrorMessage;
   mutable QString m_NewestModlistBackup;
-  mutable std::set<QString> m_MissingMasters;
-  mutable std::map<QString, std::set<QString>> m_PluginChildren;
+  mutable std::shared_ptr<const OverwriteSummary> m_OverwriteSummary;
+  mutable std::vector<FontProblem> m_FontProblems;
+  mutable PluginGraph::Problems m_PluginProblems;
+
+  // inactive mods that would provide each missing master, as html
+  mutable std::map<QString, QString> m_MasterSources;
+  mutable std::vector<Move> m_AssetMoves;
+  mutable std::vector<SortedGroup> m_AssetGroups;
+  mutable PluginGraph m_PluginGraph;
+  mutable std::mutex m_ModsMutex;
+  mutable std::shared_ptr<const ModSnapshot> m_Mods;
+  mutable std::mutex m_ProvidersMutex;
+  mutable std::shared_ptr<const PluginProviders> m_Providers;
+  mutable std::shared_ptr<const ModSnapshot> m_ProvidersMods;
+
+  // configuration files read by the checks and shown again in the descriptions
+  ParsedFileCache<FontConfig> m_FontConfigs;
+  ParsedFileCache<QString> m_ProfileTweaks;
+
+  // the state of the checks is changed by the gui thread callbacks and by every
+  // thread calling activeProblems()
+  mutable std::mutex m_ChecksMutex;
+  mutable std::map<unsigned int, CheckState> m_Checks;
+  mutable CheckMetrics m_Metrics;
+  mutable std::mutex m_SettingsMutex;
+  mutable std::optional<Settings> m_Settings;
+  mutable bool m_Batching = false;
+  OverwriteWatcher m_OverwriteWatcher;
+
+  // calls invalidate(), which the interface only offers to non-const functions
+  std::function<void()> m_NotifyInvalidated;
+
+  // declared last so that running checks are finished before anything else is
+  // destroyed
+  mutable CheckScheduler m_Scheduler;
 };
 
 #endif  // DIAGNOSEBASIC_H
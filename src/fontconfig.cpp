@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "fontconfig.h"
+
+#include <initializer_list>
+#include <string_view>
+
+namespace
+{
+
+struct Token
+{
+  enum Type
+  {
+    Word,
+    Quoted,
+    Equals
+  };
+
+  Type type;
+  std::string_view text;
+};
+
+bool isSpace(char c)
+{
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+// splits a line into bare words, quoted strings and equal signs, returns false if a
+// quoted string is not terminated
+//
+// inside quoted strings, a backslash only escapes a quote or another backslash so
+// that the character lists can contain them, other backslashes are path separators;
+// the text of the token is kept as written
+bool tokenize(std::string_view line, std::vector<Token>& tokens)
+{
+  tokens.clear();
+
+  std::size_t pos = 0;
+  while (pos < line.size()) {
+    const char c = line[pos];
+    if (isSpace(c)) {
+      ++pos;
+    } else if (c == '"') {
+      std::size_t end = pos + 1;
+      while (end < line.size() && line[end] != '"') {
+        if (line[end] == '\\' && end + 1 < line.size() &&
+            (line[end + 1] == '"' || line[end + 1] == '\\')) {
+          ++end;
+        }
+        ++end;
+      }
+      if (end >= line.size()) {
+        return false;
+      }
+      tokens.push_back({Token::Quoted, line.substr(pos + 1, end - pos - 1)});
+      pos = end + 1;
+    } else if (c == '=') {
+      tokens.push_back({Token::Equals, line.substr(pos, 1)});
+      ++pos;
+    } else {
+      std::size_t end = pos;
+      while (end < line.size() && !isSpace(line[end]) && line[end] != '"' &&
+             line[end] != '=') {
+        ++end;
+      }
+      tokens.push_back({Token::Word, line.substr(pos, end - pos)});
+      pos = end;
+    }
+  }
+
+  return true;
+}
+
+bool matches(const std::vector<Token>& tokens,
+             std::initializer_list<Token::Type> pattern)
+{
+  if (tokens.size() < pattern.size() + 1) {
+    return false;
+  }
+
+  auto token = tokens.begin() + 1;
+  for (Token::Type type : pattern) {
+    if ((token++)->type != type) {
+      return false;
+    }
+  }
+  return true;
+}
+
+QString toString(std::string_view text)
+{
+  return QString::fromUtf8(text.data(), static_cast<qsizetype>(text.size()));
+}
+
+}  // namespace
+
+FontConfig FontConfig::parse(const QByteArray& data)
+{
+  FontConfig config;
+  std::vector<Token> tokens;
+
+  std::string_view content(data.constData(), data.size());
+  if (content.substr(0, 3) == "\xEF\xBB\xBF") {
+    content.remove_prefix(3);
+  }
+
+  std::size_t start = 0;
+  int line          = 0;
+  while (start < content.size()) {
+    std::size_t end = content.find('\n', start);
+    if (end == std::string_view::npos) {
+      end = content.size();
+    }
+    const std::string_view row = content.substr(start, end - start);
+    start                      = end + 1;
+    ++line;
+
+    const bool complete = tokenize(row, tokens);
+    if (tokens.empty() || tokens[0].type != Token::Word) {
+      continue;
+    }
+
+    const std::string_view keyword = tokens[0].text;
+    if (keyword == "fontlib") {
+      if (complete && tokens.size() == 2 && matches(tokens, {Token::Quoted})) {
+        config.m_Libraries.push_back({line, toString(tokens[1].text)});
+        continue;
+      }
+    } else if (keyword == "map") {
+      // the style after the font name is optional
+      if (complete && tokens.size() <= 5 &&
+          matches(tokens, {Token::Quoted, Token::Equals, Token::Quoted}) &&
+          (tokens.size() == 4 || tokens[4].type == Token::Word)) {
+        config.m_Mappings.push_back(
+            {line, toString(tokens[1].text), toString(tokens[3].text)});
+        continue;
+      }
+    } else if (keyword == "validNameChars") {
+      if (complete && tokens.size() == 3 &&
+          matches(tokens, {Token::Quoted, Token::Quoted})) {
+        config.m_NameChars.push_back({line, toString(tokens[1].text)});
+        continue;
+      }
+    } else {
+      continue;
+    }
+
+    config.m_Malformed.push_back({line, toString(row).trimmed()});
+  }
+
+  return config;
+}
@@ -0,0 +1,85 @@
+/*
+Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+
+This file is part of basic diagnosis plugin for MO
+
+This plugin is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This plugin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef FONTCONFIG_H
+#define FONTCONFIG_H
+
+#include <QByteArray>
+#include <QString>
+
+#include <vector>
+
+// parsed content of interface/fontconfig.txt
+//
+// the file consists of one directive per line:
+//
+//   fontlib "Interface\fonts_en.swf"
+//   map "$ConsoleFont" = "Arial" Normal
+//   validNameChars "$EverywhereFont" "abc..."
+//
+// lines with other keywords are ignored, lines with a known keyword that do not
+// follow this form are reported as malformed
+class FontConfig
+{
+public:
+  // a font library to load, relative to the data directory
+  struct Library
+  {
+    int line;
+    QString path;
+  };
+
+  // an alias used by the interface for a font of the loaded libraries
+  struct Mapping
+  {
+    int line;
+    QString alias;
+    QString font;
+  };
+
+  // the characters allowed in names typed with the font of an alias
+  struct NameChars
+  {
+    int line;
+    QString alias;
+  };
+
+  // a directive that could not be parsed
+  struct Malformed
+  {
+    int line;
+    QString text;
+  };
+
+  // parses the whole file in a single pass
+  static FontConfig parse(const QByteArray& data);
+
+  const std::vector<Library>& libraries() const { return m_Libraries; }
+  const std::vector<Mapping>& mappings() const { return m_Mappings; }
+  const std::vector<NameChars>& nameChars() const { return m_NameChars; }
+  const std::vector<Malformed>& malformed() const { return m_Malformed; }
+
+private:
+  std::vector<Library> m_Libraries;
+  std::vector<Mapping> m_Mappings;
+  std::vector<NameChars> m_NameChars;
+  std::vector<Malformed> m_Malformed;
+};
+
+#endif  // FONTCONFIG_H
@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "logscanner.h"
+
+#include "checkmetrics.h"
+
+#include <QByteArray>
+#include <QFile>
+#include <QFileInfo>
+
+#include <cstring>
+
+static constexpr std::string_view ERROR_TAG   = "ERROR";
+static constexpr std::string_view WARNING_TAG = "WARNING";
+
+bool LogScanner::scan(const QString& path, int contextRows, bool includeWarnings)
+{
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly) || file.size() == 0) {
+    reset();
+    return false;
+  }
+
+  // birth time is not available on every file system, in which case only the path
+  // and the size are used to identify the file
+  const QDateTime created = QFileInfo(file).birthTime();
+  if (path != m_Path || created != m_Created || file.size() < m_Size ||
+      includeWarnings != m_IncludeWarnings) {
+    reset();
+    m_Path            = path;
+    m_Created         = created;
+    m_IncludeWarnings = includeWarnings;
+  }
+  m_Size = file.size();
+
+  // mapping may fail on some file systems, fall back to reading the file in that
+  // case
+  QByteArray buffer;
+  const char* begin = reinterpret_cast<const char*>(file.map(0, file.size()));
+  if (begin == nullptr) {
+    buffer = file.readAll();
+    begin  = buffer.constData();
+  }
+  const std::string_view data(begin, static_cast<std::size_t>(file.size()));
+
+  // only the part appended since the last pass is read
+  if (m_Offset > 0) {
+    CheckMetrics::addCacheHit();
+  }
+  CheckMetrics::addBytes(data.size() - m_Offset);
+  m_Offset = scanEntries(data, m_Offset);
+
+  if (!m_LastError) {
+    return false;
+  }
+
+  // the context is extracted again since lines following the error may have been
+  // appended in the meantime
+  m_Context = extractContext(data, *m_LastError, contextRows);
+  return true;
+}
+
+void LogScanner::reset()
+{
+  m_Path.clear();
+  m_Created         = QDateTime();
+  m_Size            = 0;
+  m_IncludeWarnings = false;
+  m_Offset          = 0;
+  m_LastError.reset();
+  m_Entries.clear();
+  m_EntryIndex.clear();
+  m_Unlisted = 0;
+  m_Context.clear();
+}
+
+std::size_t LogScanner::nextLine(std::string_view data, std::size_t pos)
+{
+  const void* newline = std::memchr(data.data() + pos, '\n', data.size() - pos);
+  if (newline == nullptr) {
+    return data.size();
+  }
+  return static_cast<const char*>(newline) - data.data() + 1;
+}
+
+std::size_t LogScanner::previousLine(std::string_view data, std::size_t pos)
+{
+  if (pos == 0) {
+    return 0;
+  }
+
+  // pos - 1 is the newline terminating the previous line
+  std::size_t start = pos - 1;
+  while (start > 0 && data[start - 1] != '\n') {
+    --start;
+  }
+  return start;
+}
+
+std::size_t LogScanner::scanEntries(std::string_view data, std::size_t from)
+{
+  std::size_t pos = from;
+  while (pos < data.size()) {
+    const std::size_t end = nextLine(data, pos);
+    const bool error      = data.substr(pos, ERROR_TAG.size()) == ERROR_TAG;
+
+    // a trailing line without newline may still be written to, so it is only
+    // aggregated once it is complete but can already be shown as context
+    if (end == data.size() && data.back() != '\n') {
+      if (error) {
+        m_LastError = pos;
+      }
+      break;
+    }
+
+    if (error) {
+      m_LastError = pos;
+      addEntry(true, data.substr(pos, end - pos));
+    } else if (m_IncludeWarnings &&
+               data.substr(pos, WARNING_TAG.size()) == WARNING_TAG) {
+      addEntry(false, data.substr(pos, end - pos));
+    }
+
+    pos = end;
+  }
+
+  return pos;
+}
+
+void LogScanner::addEntry(bool error, std::string_view line)
+{
+  std::string_view rest = line.substr(error ? ERROR_TAG.size() : WARNING_TAG.size());
+  while (!rest.empty() && (rest.back() == '\n' || rest.back() == '\r')) {
+    rest.remove_suffix(1);
+  }
+  while (!rest.empty() && rest.front() == ' ') {
+    rest.remove_prefix(1);
+  }
+
+  // entries may carry a timestamp in parentheses or brackets right after the level
+  std::string_view time;
+  if (!rest.empty() && (rest.front() == '(' || rest.front() == '[')) {
+    const std::size_t close = rest.find(rest.front() == '(' ? ')' : ']');
+    if (close != std::string_view::npos) {
+      time = rest.substr(1, close - 1);
+      rest.remove_prefix(close + 1);
+    }
+  }
+  while (!rest.empty() && (rest.front() == ' ' || rest.front() == ':')) {
+    rest.remove_prefix(1);
+  }
+
+  rest = rest.substr(0, MAX_MESSAGE_LENGTH);
+  const QString message =
+      QString::fromUtf8(rest.data(), static_cast<qsizetype>(rest.size()));
+  const QString timestamp =
+      QString::fromUtf8(time.data(), static_cast<qsizetype>(time.size()));
+
+  const QString key = QString(error ? "E" : "W") + message;
+  auto iter         = m_EntryIndex.constFind(key);
+  if (iter != m_EntryIndex.constEnd()) {
+    Entry& entry = m_Entries[*iter];
+    ++entry.count;
+    entry.lastTime = timestamp;
+    return;
+  }
+
+  if (static_cast<int>(m_Entries.size()) >= MAX_ENTRIES) {
+    ++m_Unlisted;
+    return;
+  }
+
+  m_EntryIndex.insert(key, m_Entries.size());
+  m_Entries.push_back(Entry{error, message, 1, timestamp, timestamp});
+}
+
+QStringList LogScanner::extractContext(std::string_view data, std::size_t errorLine,
+                                       int contextRows)
+{
+  // the rows before the error include the error itself, as the error is usually
+  // followed by more details
+  std::size_t start = errorLine;
+  for (int i = 1; i < contextRows && start > 0; ++i) {
+    start = previousLine(data, start);
+  }
+
+  QStringList lines;
+  for (int i = 0; i < 2 * contextRows && start < data.size(); ++i) {
+    const std::size_t end = nextLine(data, start);
+    std::string_view line = data.substr(start, end - start);
+    while (!line.empty() && (line.back() == '\n' || line.back() == '\r')) {
+      line.remove_suffix(1);
+    }
+    lines.append(QString::fromUtf8(line.data(), static_cast<qsizetype>(line.size())));
+    start = end;
+  }
+
+  return lines;
+}
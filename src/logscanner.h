@@ -0,0 +1,122 @@
+/*
+Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+
+This file is part of basic diagnosis plugin for MO
+
+This plugin is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This plugin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOGSCANNER_H
+#define LOGSCANNER_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+// searches log files for lines starting with ERROR, and optionally WARNING
+//
+// the file is memory-mapped, so neither the length of the lines nor the number of
+// lines is limited; since logs are append-only, the scanner remembers how far it got
+// in the file and only scans the bytes appended since the previous call
+//
+// every entry found is aggregated with the identical ones, the number of distinct
+// entries and the length of their messages are bounded so that huge logs with
+// thousands of repeated errors take a fixed amount of memory
+class LogScanner
+{
+public:
+  // identical log entries, grouped
+  struct Entry
+  {
+    bool error;
+    QString message;
+    int count;
+    QString firstTime;
+    QString lastTime;
+  };
+
+  // maps the given log file and aggregates the entries written to it, returns false
+  // if the file cannot be read or does not contain any error
+  //
+  // if the file is the same one as in the previous call, only the lines appended
+  // since then are searched; a different, replaced or truncated file, or a change
+  // of includeWarnings, restarts the scan from the beginning of the file
+  //
+  // on success, context() holds the most recent error line and the lines around it
+  bool scan(const QString& path, int contextRows, bool includeWarnings);
+
+  // forgets the checkpoint so the next scan starts from the beginning of the file
+  void reset();
+
+  // lines surrounding the most recent error, including the error line itself
+  const QStringList& context() const { return m_Context; }
+
+  // distinct entries, in the order of their first occurrence
+  const std::vector<Entry>& entries() const { return m_Entries; }
+
+  // number of entries that were not aggregated because there were too many
+  // distinct ones
+  int unlisted() const { return m_Unlisted; }
+
+private:
+  // maximum number of distinct entries that are kept
+  static const int MAX_ENTRIES = 200;
+
+  // messages longer than this are truncated before being grouped
+  static const int MAX_MESSAGE_LENGTH = 500;
+
+  // offset of the start of the line following the one containing pos
+  static std::size_t nextLine(std::string_view data, std::size_t pos);
+
+  // offset of the start of the line preceding the one starting at pos
+  static std::size_t previousLine(std::string_view data, std::size_t pos);
+
+  // extracts contextRows lines before the error and contextRows lines after it
+  static QStringList extractContext(std::string_view data, std::size_t errorLine,
+                                    int contextRows);
+
+  // aggregates every entry in the complete lines starting at the given line start,
+  // returns the start of the first incomplete line
+  std::size_t scanEntries(std::string_view data, std::size_t from);
+
+  // adds a single entry line to the aggregated entries
+  void addEntry(bool error, std::string_view line);
+
+private:
+  // identity of the scanned file, used to detect rotated or truncated logs
+  QString m_Path;
+  QDateTime m_Created;
+  qint64 m_Size          = 0;
+  bool m_IncludeWarnings = false;
+
+  // start of the first line that has not been scanned completely
+  std::size_t m_Offset = 0;
+
+  // start of the most recent error line found so far
+  std::optional<std::size_t> m_LastError;
+
+  std::vector<Entry> m_Entries;
+  QHash<QString, std::size_t> m_EntryIndex;
+  int m_Unlisted = 0;
+
+  QStringList m_Context;
+};
+
+#endif  // LOGSCANNER_H
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "modsnapshot.h"
+
+#include <uibase/imodinterface.h>
+
+using namespace MOBase;
+
+ModSnapshot::ModSnapshot(const IModList& list)
+{
+  const QStringList names = list.allMods();
+  m_Mods.reserve(names.size());
+  m_Index.reserve(names.size());
+
+  for (const QString& name : names) {
+    const IModInterface* mod = list.getMod(name);
+    m_Index.insert(name, m_Mods.size());
+    m_Mods.push_back(Mod{name, list.state(name), list.priority(name),
+                         mod != nullptr ? mod->absolutePath() : QString()});
+  }
+}
+
+const ModSnapshot::Mod* ModSnapshot::find(const QString& name) const
+{
+  auto it = m_Index.constFind(name);
+  return it == m_Index.cend() ? nullptr : &m_Mods[*it];
+}
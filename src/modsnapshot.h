@@ -0,0 +1,64 @@
+/*
+Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+
+This file is part of basic diagnosis plugin for MO
+
+This plugin is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This plugin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MODSNAPSHOT_H
+#define MODSNAPSHOT_H
+
+#include <QHash>
+#include <QString>
+
+#include <uibase/imodlist.h>
+
+#include <vector>
+
+// state of every mod in the mod list, collected in a single pass and shared by the
+// checks that iterate mods so that each of them does not query the organizer for
+// every mod
+//
+// only copies are kept, so the snapshot can be read from any thread while the mod
+// list changes
+class ModSnapshot
+{
+public:
+  struct Mod
+  {
+    QString name;
+    MOBase::IModList::ModStates state;
+    int priority;
+
+    // absolute path of the mod directory, empty for entries without a mod
+    QString path;
+
+    bool isActive() const { return state.testFlag(MOBase::IModList::STATE_ACTIVE); }
+  };
+
+  explicit ModSnapshot(const MOBase::IModList& list);
+
+  // mods in the order given by IModList::allMods(), which is not their priority
+  const std::vector<Mod>& mods() const { return m_Mods; }
+
+  // the mod with the given name, or null if it is not in the list
+  const Mod* find(const QString& name) const;
+
+private:
+  std::vector<Mod> m_Mods;
+  QHash<QString, std::size_t> m_Index;
+};
+
+#endif  // MODSNAPSHOT_H
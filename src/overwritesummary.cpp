@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "overwritesummary.h"
+
+#include "checkmetrics.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QObject>
+
+#include <algorithm>
+#include <utility>
+
+OverwriteSummary OverwriteSummary::scan(const QString& path)
+{
+  OverwriteSummary summary;
+  QHash<QString, int> directoryIndex;
+  QHash<QString, int> extensionIndex;
+
+  const QDir root(path);
+  QDirIterator iter(path, QDir::Files | QDir::Hidden | QDir::System,
+                    QDirIterator::Subdirectories);
+  while (iter.hasNext()) {
+    if (summary.m_Total.files >= MAX_FILES) {
+      summary.m_Complete = false;
+      break;
+    }
+
+    iter.next();
+    CheckMetrics::addFiles();
+
+    // the file information comes from the directory listing, no additional call is
+    // needed on most platforms
+    const QFileInfo info    = iter.fileInfo();
+    const QString relative  = root.relativeFilePath(info.filePath());
+    const qint64 size       = info.size();
+    const QDateTime changed = info.lastModified();
+    const QString tool      = guessTool(relative);
+
+    const int separator     = relative.indexOf('/');
+    const QString directory = separator < 0 ? QString() : relative.left(separator);
+
+    add(summary.m_Total, size, changed, tool);
+    add(summary.m_Directories, directoryIndex, directory, size, changed, tool);
+    add(summary.m_Extensions, extensionIndex, info.suffix().toLower(), size, changed,
+        tool);
+  }
+
+  // largest groups first
+  for (auto* groups : {&summary.m_Directories, &summary.m_Extensions}) {
+    std::sort(groups->begin(), groups->end(), [](const Group& lhs, const Group& rhs) {
+      return lhs.bytes > rhs.bytes;
+    });
+  }
+
+  return summary;
+}
+
+QString OverwriteSummary::guessTool(const QString& relativePath)
+{
+  // fragments of paths commonly produced by the usual mod tools
+  static const std::vector<std::pair<QString, QString>> fragments{
+      {"FNIS", "FNIS"},
+      {"Nemesis", "Nemesis"},
+      {"DynDOLOD", "DynDOLOD"},
+      {"TexGen", "TexGen"},
+      {"xLODGen", "xLODGen"},
+      {"Bashed Patch", "Wrye Bash"},
+      {"Edit Backups", "xEdit"},
+      {"Edit Cache", "xEdit"},
+      {"CalienteTools", "BodySlide"},
+      {"BodySlide", "BodySlide"},
+      {"ShaderCache", "ENB"},
+      {"SKSE", "Script Extender"},
+      {".log", "Logs"}};
+
+  for (const auto& [fragment, tool] : fragments) {
+    if (relativePath.contains(fragment, Qt::CaseInsensitive)) {
+      return tool;
+    }
+  }
+
+  return {};
+}
+
+void OverwriteSummary::add(Group& group, qint64 size, const QDateTime& modified,
+                           const QString& tool)
+{
+  ++group.files;
+  group.bytes += size;
+  if (!group.oldest.isValid() || modified < group.oldest) {
+    group.oldest = modified;
+  }
+  if (!group.newest.isValid() || modified > group.newest) {
+    group.newest = modified;
+  }
+  if (group.tool.isEmpty()) {
+    group.tool = tool;
+  }
+}
+
+void OverwriteSummary::add(std::vector<Group>& groups, QHash<QString, int>& index,
+                           const QString& name, qint64 size, const QDateTime& modified,
+                           const QString& tool)
+{
+  auto iter = index.constFind(name);
+  if (iter == index.constEnd()) {
+    // the last slot is reserved for the "other" group
+    const bool full         = static_cast<int>(groups.size()) >= MAX_GROUPS - 1;
+    const QString groupName = full ? QObject::tr("(other)") : name;
+
+    iter = index.constFind(groupName);
+    if (iter == index.constEnd()) {
+      Group group;
+      group.name = groupName;
+      groups.push_back(group);
+      iter = index.insert(groupName, static_cast<int>(groups.size()) - 1);
+    }
+  }
+
+  add(groups[*iter], size, modified, tool);
+}
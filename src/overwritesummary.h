@@ -0,0 +1,94 @@
+/*
+Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+
+This file is part of basic diagnosis plugin for MO
+
+This plugin is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This plugin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OVERWRITESUMMARY_H
+#define OVERWRITESUMMARY_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QString>
+
+#include <vector>
+
+// breakdown of the content of the overwrite directory by top-level directory and by
+// extension, computed in a single walk
+//
+// the number of groups is bounded, entries beyond that limit are folded into a
+// single "other" group so that very large directories take a fixed amount of memory;
+// the walk itself stops after a fixed number of files so that it takes a bounded time
+class OverwriteSummary
+{
+public:
+  struct Group
+  {
+    QString name;
+    int files    = 0;
+    qint64 bytes = 0;
+    QDateTime oldest;
+    QDateTime newest;
+
+    // tool that most likely generated the files, empty if unknown
+    QString tool;
+  };
+
+  // walks the given directory and aggregates its files, up to MAX_FILES of them
+  static OverwriteSummary scan(const QString& path);
+
+  // false if the walk stopped before the end of the directory, the groups and totals
+  // then only cover the files seen so far
+  bool complete() const { return m_Complete; }
+
+  // groups by top-level directory, files directly in the directory are grouped under
+  // an empty name
+  const std::vector<Group>& directories() const { return m_Directories; }
+
+  // groups by lowercase file extension
+  const std::vector<Group>& extensions() const { return m_Extensions; }
+
+  // totals over every file
+  const Group& total() const { return m_Total; }
+
+private:
+  // maximum number of groups kept for each breakdown, including the "other" group
+  static const int MAX_GROUPS = 32;
+
+  // maximum number of files walked
+  static const int MAX_FILES = 20000;
+
+  // guesses the tool that generated a file from its path relative to the directory
+  static QString guessTool(const QString& relativePath);
+
+  // adds a file to a group
+  static void add(Group& group, qint64 size, const QDateTime& modified,
+                  const QString& tool);
+
+  // adds a file to the group with the given name, or to the "other" group if there
+  // are already too many groups
+  static void add(std::vector<Group>& groups, QHash<QString, int>& index,
+                  const QString& name, qint64 size, const QDateTime& modified,
+                  const QString& tool);
+
+private:
+  std::vector<Group> m_Directories;
+  std::vector<Group> m_Extensions;
+  Group m_Total;
+  bool m_Complete = true;
+};
+
+#endif  // OVERWRITESUMMARY_H
@@ -0,0 +1,304 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "overwritewatcher.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+
+#include <algorithm>
+
+OverwriteWatcher::OverwriteWatcher(const QRegularExpression& logFile, QObject* parent)
+    : QObject(parent), m_LogFile(logFile), m_Watcher(new QFileSystemWatcher),
+      m_Delay(new QTimer)
+{
+  m_Thread.setObjectName("overwrite watcher");
+
+  m_Delay->setSingleShot(true);
+  m_Delay->setInterval(500);
+
+  // the notifications are handled on the thread of the watcher, the signal is
+  // forwarded to the thread of this object
+  connect(m_Delay, &QTimer::timeout, this, &OverwriteWatcher::changed);
+  connect(m_Watcher, &QFileSystemWatcher::directoryChanged, m_Watcher,
+          [this](const QString& path) {
+            onDirectoryChanged(path);
+          });
+}
+
+OverwriteWatcher::~OverwriteWatcher()
+{
+  if (m_Thread.isRunning()) {
+    // deferred deletions are processed when the thread finishes
+    m_Watcher->deleteLater();
+    m_Delay->deleteLater();
+    m_Thread.quit();
+    m_Thread.wait();
+  } else {
+    delete m_Delay;
+    delete m_Watcher;
+  }
+}
+
+void OverwriteWatcher::watch(const QString& path)
+{
+  if (!m_Thread.isRunning()) {
+    m_Watcher->moveToThread(&m_Thread);
+    m_Delay->moveToThread(&m_Thread);
+    m_Thread.start(QThread::LowPriority);
+  }
+
+  QMetaObject::invokeMethod(
+      m_Watcher,
+      [this, path]() {
+        start(path);
+      },
+      Qt::QueuedConnection);
+}
+
+void OverwriteWatcher::stop()
+{
+  if (!m_Thread.isRunning()) {
+    return;
+  }
+
+  QMetaObject::invokeMethod(
+      m_Watcher,
+      [this]() {
+        clear();
+      },
+      Qt::QueuedConnection);
+}
+
+bool OverwriteWatcher::isTracking() const
+{
+  std::scoped_lock lock(m_Mutex);
+  return m_Ready && m_Reliable;
+}
+
+std::optional<bool> OverwriteWatcher::hasContent(const QStringList& mappings,
+                                                 bool ignoreEmpty, bool ignoreLog) const
+{
+  std::scoped_lock lock(m_Mutex);
+
+  if (!m_Ready || !m_Reliable) {
+    return {};
+  }
+
+  if (ignoreEmpty || ignoreLog) {
+    return m_OtherFiles > 0 || (!ignoreLog && m_LogFiles > 0);
+  }
+
+  bool checkDirs = mappings.size() > 1 || (!mappings.isEmpty() && mappings[0] != "");
+  if (checkDirs) {
+    for (const QString& mapping : mappings) {
+      const Directory* directory = find(mapping);
+      if (directory != nullptr && directory->visible > 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  const Directory* root = find("");
+  return root != nullptr && root->visible > 0;
+}
+
+void OverwriteWatcher::start(const QString& path)
+{
+  clear();
+
+  const QString root = QDir(path).absolutePath();
+  {
+    std::scoped_lock lock(m_Mutex);
+    m_Root     = root;
+    m_Reliable = QDir(root).exists();
+  }
+
+  add(root);
+
+  {
+    std::scoped_lock lock(m_Mutex);
+    m_Ready = true;
+  }
+
+  // the check walked the directory until now
+  m_Delay->start();
+}
+
+void OverwriteWatcher::clear()
+{
+  if (!m_Watcher->directories().isEmpty()) {
+    m_Watcher->removePaths(m_Watcher->directories());
+  }
+
+  std::scoped_lock lock(m_Mutex);
+  m_Directories.clear();
+  m_LogFiles   = 0;
+  m_OtherFiles = 0;
+  m_Reliable   = false;
+  m_Ready      = false;
+}
+
+void OverwriteWatcher::onDirectoryChanged(const QString& path)
+{
+  {
+    std::scoped_lock lock(m_Mutex);
+    if (!m_Directories.contains(path)) {
+      return;
+    }
+  }
+
+  if (!QDir(path).exists()) {
+    // the parent is notified as well and drops the directory from its listing
+    remove(path);
+    if (path == m_Root) {
+      std::scoped_lock lock(m_Mutex);
+      m_Reliable = false;
+    }
+  } else {
+    QStringList added, removed;
+    update(path, added, removed);
+    for (const QString& subdirectory : removed) {
+      remove(path + "/" + subdirectory);
+    }
+    for (const QString& subdirectory : added) {
+      add(path + "/" + subdirectory);
+    }
+  }
+
+  m_Delay->start();
+}
+
+void OverwriteWatcher::update(const QString& path, QStringList& added,
+                              QStringList& removed)
+{
+  Directory updated;
+  for (const QFileInfo& entry : QDir(path).entryInfoList(
+           QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System)) {
+    if (!entry.isHidden()) {
+      ++updated.visible;
+    }
+
+    if (entry.isDir()) {
+      if (!entry.isSymLink()) {
+        updated.subdirectories.append(entry.fileName());
+      }
+    } else if (m_LogFile.match(entry.fileName()).hasMatch()) {
+      ++updated.logFiles;
+    } else {
+      ++updated.otherFiles;
+    }
+  }
+
+  std::scoped_lock lock(m_Mutex);
+
+  const Directory previous = m_Directories.value(path);
+  for (const QString& subdirectory : updated.subdirectories) {
+    if (!previous.subdirectories.contains(subdirectory)) {
+      added.append(subdirectory);
+    }
+  }
+  for (const QString& subdirectory : previous.subdirectories) {
+    if (!updated.subdirectories.contains(subdirectory)) {
+      removed.append(subdirectory);
+    }
+  }
+
+  m_LogFiles += updated.logFiles - previous.logFiles;
+  m_OtherFiles += updated.otherFiles - previous.otherFiles;
+  m_Directories.insert(path, updated);
+}
+
+void OverwriteWatcher::add(const QString& path)
+{
+  bool full = false;
+  {
+    std::scoped_lock lock(m_Mutex);
+    if (!m_Reliable) {
+      return;
+    }
+    full = m_Directories.size() >= MAX_DIRECTORIES;
+  }
+
+  // the number of watches is also limited on some systems, the model cannot be
+  // trusted anymore if one of them is missing
+  if (full || !m_Watcher->addPath(path)) {
+    qWarning() << "Not watching" << m_Root
+               << (full ? "with too many directories" : "after failing to watch")
+               << path;
+    clear();
+    return;
+  }
+
+  // listed after the watch is added so that no change is missed
+  QStringList added, removed;
+  update(path, added, removed);
+
+  for (const QString& subdirectory : added) {
+    add(path + "/" + subdirectory);
+  }
+}
+
+void OverwriteWatcher::remove(const QString& path)
+{
+  Directory directory;
+  {
+    std::scoped_lock lock(m_Mutex);
+    if (!m_Directories.contains(path)) {
+      return;
+    }
+
+    directory = m_Directories.take(path);
+    m_LogFiles -= directory.logFiles;
+    m_OtherFiles -= directory.otherFiles;
+  }
+
+  m_Watcher->removePath(path);
+
+  for (const QString& subdirectory : directory.subdirectories) {
+    remove(path + "/" + subdirectory);
+  }
+}
+
+const OverwriteWatcher::Directory* OverwriteWatcher::find(const QString& relative) const
+{
+  QString path = m_Root;
+  for (const QString& component :
+       QDir::fromNativeSeparators(relative).split('/', Qt::SkipEmptyParts)) {
+    auto iter = m_Directories.constFind(path);
+    if (iter == m_Directories.constEnd()) {
+      return nullptr;
+    }
+
+    auto subdirectory =
+        std::find_if(iter->subdirectories.begin(), iter->subdirectories.end(),
+                     [&](const QString& name) {
+                       return name.compare(component, Qt::CaseInsensitive) == 0;
+                     });
+    if (subdirectory == iter->subdirectories.end()) {
+      return nullptr;
+    }
+    path += "/" + *subdirectory;
+  }
+
+  auto iter = m_Directories.constFind(path);
+  return iter == m_Directories.constEnd() ? nullptr : &*iter;
+}
@@ -0,0 +1,133 @@
+/*
+Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+
+This file is part of basic diagnosis plugin for MO
+
+This plugin is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This plugin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OVERWRITEWATCHER_H
+#define OVERWRITEWATCHER_H
+
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QObject>
+#include <QRegularExpression>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include <QTimer>
+
+#include <mutex>
+#include <optional>
+
+// keeps a live model of the overwrite directory, updated through file system
+// notifications, so that checking it for content does not require walking the tree
+//
+// the directories are listed and watched on a thread of their own, the model can be
+// queried from any thread; trees with too many directories are not watched at all
+// and the model reports itself as unreliable, so callers walk the directory instead
+class OverwriteWatcher : public QObject
+{
+  Q_OBJECT
+
+public:
+  // log files are the files whose name matches the given expression
+  OverwriteWatcher(const QRegularExpression& logFile, QObject* parent = nullptr);
+  ~OverwriteWatcher();
+
+  // starts building the model of the given directory in the background and watching
+  // it and all its subdirectories, replacing the previous one
+  void watch(const QString& path);
+
+  // stops watching, the model is unreliable until watch() is called again
+  void stop();
+
+  // returns whether the overwrite directory has content, or nothing if the model is
+  // not built yet or is unreliable because some directories are not watched
+  //
+  // with ignoreEmpty or ignoreLog, only files count, excluding log files for the
+  // latter; otherwise any visible entry counts, either in the given mapping roots or
+  // in the directory itself if there are no mappings
+  std::optional<bool> hasContent(const QStringList& mappings, bool ignoreEmpty,
+                                 bool ignoreLog) const;
+
+  // returns whether the model is built and every directory is watched, in which case
+  // changed() is emitted for every change of the content
+  bool isTracking() const;
+
+signals:
+  // emitted, with a short delay to coalesce bursts of changes, after the content of
+  // the overwrite directory changed or the model has been built
+  void changed();
+
+private:
+  struct Directory
+  {
+    int logFiles   = 0;
+    int otherFiles = 0;
+    int visible    = 0;
+    QStringList subdirectories;
+  };
+
+  // every watched directory costs a handle, and on Windows a thread for every 63 of
+  // them, so larger trees are walked by the check instead
+  static constexpr qsizetype MAX_DIRECTORIES = 512;
+
+  // the following functions run on the thread of the watcher
+
+  // builds the model of the given directory
+  void start(const QString& path);
+
+  // stops watching every directory and drops the model
+  void clear();
+
+  void onDirectoryChanged(const QString& path);
+
+  // lists the given directory and updates its entry in the model, returns the
+  // subdirectories that were added and removed since the previous listing
+  void update(const QString& path, QStringList& added, QStringList& removed);
+
+  // watches the given directory and all its subdirectories and adds them to the
+  // model, the model is dropped if one of them cannot be watched
+  void add(const QString& path);
+
+  // removes the given directory and all its subdirectories from the model
+  void remove(const QString& path);
+
+  // finds the directory at the given path relative to the root, the components of
+  // the path are compared case-insensitively like the game does
+  const Directory* find(const QString& relative) const;
+
+private:
+  QRegularExpression m_LogFile;
+
+  // started with the first call to watch(), the watcher and the timer are moved to it
+  QThread m_Thread;
+  QFileSystemWatcher* m_Watcher;
+  QTimer* m_Delay;
+
+  mutable std::mutex m_Mutex;
+  QString m_Root;
+  QHash<QString, Directory> m_Directories;
+  qint64 m_LogFiles   = 0;
+  qint64 m_OtherFiles = 0;
+
+  // the model is reliable as long as every directory is watched, and ready once the
+  // whole tree has been listed
+  bool m_Reliable = false;
+  bool m_Ready    = false;
+};
+
+#endif  // OVERWRITEWATCHER_H
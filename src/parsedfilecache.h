@@ -0,0 +1,103 @@
+/*
+Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+
+This file is part of basic diagnosis plugin for MO
+
+This plugin is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This plugin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PARSEDFILECACHE_H
+#define PARSEDFILECACHE_H
+
+#include "checkmetrics.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QString>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+
+// parsed content of small files that are read repeatedly, such as configuration
+// files shown by the checks
+//
+// entries are keyed by path, size and modification time, so a file is only read and
+// parsed again after it changed; safe to use from several threads
+template <typename T>
+class ParsedFileCache
+{
+public:
+  using Parser = std::function<T(const QByteArray&)>;
+
+  explicit ParsedFileCache(Parser parser) : m_Parser(std::move(parser)) {}
+
+  // parsed content of the given file, or null if it does not exist or cannot be read
+  std::shared_ptr<const T> get(const QString& path) const
+  {
+    const QFileInfo info(path);
+    if (!info.isFile()) {
+      return nullptr;
+    }
+
+    const qint64 size     = info.size();
+    const qint64 modified = info.lastModified().toMSecsSinceEpoch();
+
+    {
+      std::scoped_lock lock(m_Mutex);
+      auto it = m_Entries.constFind(path);
+      if (it != m_Entries.cend() && it->size == size && it->modified == modified) {
+        CheckMetrics::addCacheHit();
+        return it->value;
+      }
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+      return nullptr;
+    }
+
+    // parsed outside of the lock, two threads may parse the same file but the
+    // result is the same
+    const QByteArray data = file.readAll();
+    CheckMetrics::addBytes(data.size());
+    auto value = std::make_shared<const T>(m_Parser(data));
+
+    std::scoped_lock lock(m_Mutex);
+    m_Entries.insert(path, Entry{size, modified, value});
+    return value;
+  }
+
+  void clear()
+  {
+    std::scoped_lock lock(m_Mutex);
+    m_Entries.clear();
+  }
+
+private:
+  struct Entry
+  {
+    qint64 size;
+    qint64 modified;
+    std::shared_ptr<const T> value;
+  };
+
+  Parser m_Parser;
+  mutable std::mutex m_Mutex;
+  mutable QHash<QString, Entry> m_Entries;
+};
+
+#endif  // PARSEDFILECACHE_H
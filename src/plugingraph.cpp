@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "plugingraph.h"
+
+using namespace MOBase;
+
+void PluginGraph::rebuild(const IPluginList* plugins)
+{
+  // the plugin list is queried before locking so that checks are not blocked
+  const QStringList names = plugins->pluginNames();
+  const int pluginCount   = static_cast<int>(names.size());
+
+  QHash<QString, int> ids;
+  std::vector<QString> displayNames;
+  std::vector<bool> active;
+  std::vector<int> priorities;
+  std::vector<QStringList> masters;
+
+  ids.reserve(pluginCount);
+  displayNames.reserve(pluginCount);
+  active.reserve(pluginCount);
+  priorities.reserve(pluginCount);
+  masters.reserve(pluginCount);
+
+  for (const QString& name : names) {
+    ids.insert(key(name), static_cast<int>(displayNames.size()));
+    displayNames.push_back(name);
+    active.push_back(plugins->state(name) == IPluginList::STATE_ACTIVE);
+    priorities.push_back(plugins->priority(name));
+    masters.push_back(plugins->masters(name));
+  }
+
+  // masters are interned once all plugins have their id, the ones that are not
+  // installed are appended
+  std::vector<int> masterOffsets{0};
+  std::vector<int> masterIds;
+  masterOffsets.reserve(pluginCount + 1);
+  for (const QStringList& pluginMasters : masters) {
+    for (const QString& master : pluginMasters) {
+      auto iter = ids.constFind(key(master));
+      if (iter == ids.constEnd()) {
+        iter = ids.insert(key(master), static_cast<int>(displayNames.size()));
+        displayNames.push_back(master);
+        active.push_back(false);
+      }
+      masterIds.push_back(*iter);
+    }
+    masterOffsets.push_back(static_cast<int>(masterIds.size()));
+  }
+
+  // the reverse edges are counted first so that they can be placed directly
+  const int idCount = static_cast<int>(displayNames.size());
+  std::vector<int> childOffsets(idCount + 1, 0);
+  for (int master : masterIds) {
+    ++childOffsets[master + 1];
+  }
+  for (int id = 0; id < idCount; ++id) {
+    childOffsets[id + 1] += childOffsets[id];
+  }
+
+  std::vector<int> childIds(masterIds.size());
+  std::vector<int> fill(childOffsets.begin(), childOffsets.end() - 1);
+  for (int child = 0; child < pluginCount; ++child) {
+    for (int edge = masterOffsets[child]; edge < masterOffsets[child + 1]; ++edge) {
+      childIds[fill[masterIds[edge]]++] = child;
+    }
+  }
+
+  std::scoped_lock lock(m_Mutex);
+
+  m_PluginCount   = pluginCount;
+  m_Ids           = std::move(ids);
+  m_Names         = std::move(displayNames);
+  m_Active        = std::move(active);
+  m_Priorities    = std::move(priorities);
+  m_MasterOffsets = std::move(masterOffsets);
+  m_MasterIds     = std::move(masterIds);
+  m_ChildOffsets  = std::move(childOffsets);
+  m_ChildIds      = std::move(childIds);
+  m_Built         = true;
+}
+
+bool PluginGraph::isBuilt() const
+{
+  std::scoped_lock lock(m_Mutex);
+  return m_Built;
+}
+
+void PluginGraph::updateStates(
+    const std::map<QString, IPluginList::PluginStates>& states)
+{
+  std::scoped_lock lock(m_Mutex);
+
+  for (const auto& [name, state] : states) {
+    const int id = pluginId(name);
+    if (id >= 0) {
+      m_Active[id] = state == IPluginList::STATE_ACTIVE;
+    }
+  }
+}
+
+void PluginGraph::updatePriority(const QString& name, int oldPriority, int newPriority)
+{
+  std::scoped_lock lock(m_Mutex);
+
+  // the plugins between the old and the new position are shifted by one
+  for (int& priority : m_Priorities) {
+    if (oldPriority < newPriority && priority > oldPriority &&
+        priority <= newPriority) {
+      --priority;
+    } else if (newPriority < oldPriority && priority >= newPriority &&
+               priority < oldPriority) {
+      ++priority;
+    }
+  }
+
+  const int id = pluginId(name);
+  if (id >= 0) {
+    m_Priorities[id] = newPriority;
+  }
+}
+
+PluginGraph::Problems PluginGraph::problems() const
+{
+  std::scoped_lock lock(m_Mutex);
+
+  Problems result;
+
+  // the master that breaks each plugin, or -1; plugins with a missing or late master
+  // of their own are queued first and the breakage is then propagated to the
+  // plugins requiring them, so every edge is visited at most twice
+  std::vector<int> brokenBy(m_PluginCount, -1);
+  std::vector<int> queue;
+
+  for (int child = 0; child < m_PluginCount; ++child) {
+    if (!m_Active[child]) {
+      continue;
+    }
+
+    for (int edge = m_MasterOffsets[child]; edge < m_MasterOffsets[child + 1]; ++edge) {
+      const int master = m_MasterIds[edge];
+      if (!m_Active[master]) {
+        result.missing[m_Names[master]].insert(m_Names[child]);
+      } else if (m_Priorities[master] > m_Priorities[child]) {
+        result.late[m_Names[master]].insert(m_Names[child]);
+      } else {
+        continue;
+      }
+
+      if (brokenBy[child] < 0) {
+        brokenBy[child] = master;
+        queue.push_back(child);
+      }
+    }
+  }
+
+  for (std::size_t next = 0; next < queue.size(); ++next) {
+    const int master = queue[next];
+    for (int edge = m_ChildOffsets[master]; edge < m_ChildOffsets[master + 1]; ++edge) {
+      const int child = m_ChildIds[edge];
+      if (m_Active[child] && brokenBy[child] < 0) {
+        brokenBy[child] = master;
+        queue.push_back(child);
+        result.broken[m_Names[child]] = m_Names[master];
+      }
+    }
+  }
+
+  return result;
+}
+
+QString PluginGraph::key(const QString& name)
+{
+  return name.toLower();
+}
+
+int PluginGraph::pluginId(const QString& name) const
+{
+  const int id = m_Ids.value(key(name), -1);
+  return id < m_PluginCount ? id : -1;
+}
@@ -0,0 +1,114 @@
+/*
+Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+
+This file is part of basic diagnosis plugin for MO
+
+This plugin is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This plugin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PLUGINGRAPH_H
+#define PLUGINGRAPH_H
+
+#include <QHash>
+#include <QString>
+
+#include <map>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include <uibase/ipluginlist.h>
+
+// dependency graph between the plugins of the plugin list
+//
+// plugin names are interned to dense integer ids when the graph is built, masters
+// that are not installed get ids after the installed plugins; the state of the
+// plugins is a bitset and the masters and children are stored as compressed sparse
+// row adjacency lists, so the analysis is a loop over integers and names are only
+// looked up for the result
+//
+// updates come from the plugin list callbacks on the gui thread while the missing
+// masters can be queried from any thread
+class PluginGraph
+{
+public:
+  // problems of the active plugins, keyed by display name
+  struct Problems
+  {
+    // masters that are not active, mapped to the active plugins requiring them
+    std::map<QString, std::set<QString>> missing;
+
+    // active masters mapped to the active plugins requiring them that load earlier
+    std::map<QString, std::set<QString>> late;
+
+    // plugins whose own masters are fine but which require a plugin with problems,
+    // mapped to that master
+    std::map<QString, QString> broken;
+
+    bool empty() const { return missing.empty() && late.empty() && broken.empty(); }
+  };
+
+  // rebuilds the graph from the given plugin list
+  void rebuild(const MOBase::IPluginList* plugins);
+
+  // returns true if the graph has been built at least once
+  bool isBuilt() const;
+
+  // updates the state of the given plugins
+  void updateStates(const std::map<QString, MOBase::IPluginList::PluginStates>& states);
+
+  // updates the priorities after a plugin has been moved
+  void updatePriority(const QString& name, int oldPriority, int newPriority);
+
+  // finds missing and late masters of the active plugins and the plugins depending
+  // on those, in a single pass over the graph
+  Problems problems() const;
+
+private:
+  // case-folded key of a plugin name
+  static QString key(const QString& name);
+
+  // id of an installed plugin, or -1
+  int pluginId(const QString& name) const;
+
+private:
+  mutable std::mutex m_Mutex;
+  bool m_Built = false;
+
+  // ids below this are installed plugins, the others are masters that are not
+  // installed
+  int m_PluginCount = 0;
+
+  QHash<QString, int> m_Ids;
+
+  // display name of every id, as found in the plugin list or in the first child
+  // requiring it
+  std::vector<QString> m_Names;
+
+  // one bit per id, always false for masters that are not installed
+  std::vector<bool> m_Active;
+
+  // priority of every installed plugin
+  std::vector<int> m_Priorities;
+
+  // the masters of plugin i are m_MasterIds[m_MasterOffsets[i], m_MasterOffsets[i+1])
+  std::vector<int> m_MasterOffsets;
+  std::vector<int> m_MasterIds;
+
+  // the same for the plugins requiring each id
+  std::vector<int> m_ChildOffsets;
+  std::vector<int> m_ChildIds;
+};
+
+#endif  // PLUGINGRAPH_H
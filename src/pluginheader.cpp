@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "pluginheader.h"
+
+#include <QFile>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
+
+std::optional<QStringList> PluginHeader::readMasters(const QString& path)
+{
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly) || file.size() < RECORD_HEADER_SIZE) {
+    return {};
+  }
+
+  // the size of the record is only known once its header has been read
+  QByteArray buffer;
+  const uchar* header = file.map(0, RECORD_HEADER_SIZE);
+  if (header == nullptr) {
+    buffer = file.read(RECORD_HEADER_SIZE);
+    header = reinterpret_cast<const uchar*>(buffer.constData());
+  }
+
+  if (std::memcmp(header, "TES4", 4) != 0) {
+    return {};
+  }
+
+  const qint64 recordSize = RECORD_HEADER_SIZE + qFromLittleEndian<quint32>(header + 4);
+  const qint64 length     = std::min(file.size(), recordSize);
+  if (buffer.isEmpty()) {
+    file.unmap(const_cast<uchar*>(header));
+  }
+
+  // mapping may fail on some file systems, the record is read in that case
+  const uchar* record = file.map(0, length);
+  if (record == nullptr) {
+    file.seek(0);
+    buffer = file.read(length);
+    if (buffer.size() != length) {
+      return {};
+    }
+    record = reinterpret_cast<const uchar*>(buffer.constData());
+  }
+
+  return parse(record, length);
+}
+
+QStringList PluginHeader::parse(const uchar* record, qint64 length)
+{
+  const qint64 dataSize = qFromLittleEndian<quint32>(record + 4);
+
+  // every header record starts with a HEDR subrecord, which tells the size of the
+  // record header apart
+  qint64 offset = RECORD_HEADER_SIZE;
+  if (length < RECORD_HEADER_SIZE + 4 ||
+      std::memcmp(record + RECORD_HEADER_SIZE, "HEDR", 4) != 0) {
+    offset = OBLIVION_HEADER_SIZE;
+  }
+  const qint64 end = std::min(length, offset + dataSize);
+
+  QStringList masters;
+
+  // an XXXX subrecord holds the size of the following subrecord when it does not fit
+  // in 16 bits
+  quint32 largeSize = 0;
+  while (offset + 6 <= end) {
+    const uchar* type = record + offset;
+    qint64 size       = qFromLittleEndian<quint16>(record + offset + 4);
+    offset += 6;
+
+    if (largeSize != 0) {
+      size      = largeSize;
+      largeSize = 0;
+    }
+    if (offset + size > end) {
+      break;
+    }
+
+    if (std::memcmp(type, "XXXX", 4) == 0 && size == 4) {
+      largeSize = qFromLittleEndian<quint32>(record + offset);
+    } else if (std::memcmp(type, "MAST", 4) == 0) {
+      // the name is zero-terminated and uses the Windows code page
+      const char* name = reinterpret_cast<const char*>(record + offset);
+      masters.append(QString::fromLatin1(name, qstrnlen(name, size)));
+    }
+
+    offset += size;
+  }
+
+  return masters;
+}
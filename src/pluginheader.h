@@ -0,0 +1,49 @@
+/*
+Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+
+This file is part of basic diagnosis plugin for MO
+
+This plugin is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This plugin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PLUGINHEADER_H
+#define PLUGINHEADER_H
+
+#include <QString>
+#include <QStringList>
+
+#include <optional>
+
+// reads the masters of a plugin file (esp, esm or esl) from its TES4 header record
+//
+// only the header record at the start of the file is mapped, the MAST subrecords are
+// read directly from the mapping without copying the record
+class PluginHeader
+{
+public:
+  // masters of the given plugin in the order they are listed, nothing if the file
+  // cannot be read or does not start with a TES4 record
+  static std::optional<QStringList> readMasters(const QString& path);
+
+private:
+  // size of the record header before the subrecords, Oblivion uses 20 bytes and the
+  // later games 24
+  static constexpr qint64 RECORD_HEADER_SIZE   = 24;
+  static constexpr qint64 OBLIVION_HEADER_SIZE = 20;
+
+  // masters listed in the subrecords of the given header record
+  static QStringList parse(const uchar* record, qint64 length);
+};
+
+#endif  // PLUGINHEADER_H
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "pluginproviders.h"
+#include "pluginheader.h"
+
+#include <QDir>
+#include <QThread>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <utility>
+
+PluginProviders PluginProviders::scan(const ModSnapshot& mods)
+{
+  const std::vector<ModSnapshot::Mod>& list = mods.mods();
+  const std::size_t threads =
+      std::min<std::size_t>(std::max(QThread::idealThreadCount(), 1), list.size());
+
+  // workers take the next mod until none are left, the results are kept per worker
+  // and merged afterwards so that no lock is needed while reading
+  std::atomic<std::size_t> next = 0;
+  std::vector<std::vector<std::pair<QString, Provider>>> results(threads);
+
+  auto work = [&](std::size_t index) {
+    for (std::size_t i = next++; i < list.size(); i = next++) {
+      const ModSnapshot::Mod& mod = list[i];
+      if (mod.path.isEmpty()) {
+        continue;
+      }
+
+      const QDir dir(mod.path);
+      for (const QString& file :
+           dir.entryList({"*.esp", "*.esm", "*.esl"}, QDir::Files | QDir::Hidden)) {
+        const auto masters = PluginHeader::readMasters(dir.filePath(file));
+        results[index].emplace_back(file.toLower(),
+                                    Provider{mod.name, mod.priority, mod.isActive(),
+                                             masters.value_or(QStringList())});
+      }
+    }
+  };
+
+  std::vector<std::thread> pool;
+  for (std::size_t i = 0; i < threads; ++i) {
+    pool.emplace_back(work, i);
+  }
+  for (auto& thread : pool) {
+    thread.join();
+  }
+
+  PluginProviders providers;
+  for (auto& result : results) {
+    for (auto& [plugin, provider] : result) {
+      providers.m_Providers[plugin].push_back(std::move(provider));
+      ++providers.m_Files;
+    }
+  }
+
+  for (auto& entries : providers.m_Providers) {
+    std::sort(entries.begin(), entries.end(),
+              [](const Provider& lhs, const Provider& rhs) {
+                return lhs.priority > rhs.priority;
+              });
+  }
+
+  return providers;
+}
+
+const std::vector<PluginProviders::Provider>&
+PluginProviders::find(const QString& plugin) const
+{
+  static const std::vector<Provider> none;
+
+  auto iter = m_Providers.constFind(plugin.toLower());
+  return iter == m_Providers.cend() ? none : *iter;
+}
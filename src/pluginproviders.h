@@ -0,0 +1,62 @@
+/*
+Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+
+This file is part of basic diagnosis plugin for MO
+
+This plugin is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This plugin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PLUGINPROVIDERS_H
+#define PLUGINPROVIDERS_H
+
+#include "modsnapshot.h"
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+#include <vector>
+
+// index of the mods shipping each plugin file, active or not, along with the masters
+// read from the header of each copy
+class PluginProviders
+{
+public:
+  struct Provider
+  {
+    QString mod;
+    int priority;
+    bool active;
+
+    // masters of this copy of the plugin
+    QStringList masters;
+  };
+
+  // reads the plugins at the root of every mod, the mods are spread over a pool of
+  // threads
+  static PluginProviders scan(const ModSnapshot& mods);
+
+  // mods shipping the given plugin, highest priority first; the lookup is
+  // case-insensitive
+  const std::vector<Provider>& find(const QString& plugin) const;
+
+  // number of plugin files read
+  qsizetype size() const { return m_Files; }
+
+private:
+  QHash<QString, std::vector<Provider>> m_Providers;
+  qsizetype m_Files = 0;
+};
+
+#endif  // PLUGINPROVIDERS_H
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "archivelisting.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QtEndian>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+template <typename T>
+void append(QByteArray& data, T value)
+{
+  char bytes[sizeof(T)];
+  qToLittleEndian<T>(value, bytes);
+  data.append(bytes, sizeof(T));
+}
+
+void write(const QString& path, const QByteArray& data)
+{
+  QFile file(path);
+  ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+  file.write(data);
+}
+
+// Skyrim Special Edition archive with the given folders and files
+QByteArray bsa(const std::vector<std::pair<QByteArray, QList<QByteArray>>>& folders)
+{
+  quint32 fileCount = 0, folderNamesSize = 0, fileNamesSize = 0;
+  for (const auto& [folder, files] : folders) {
+    fileCount += files.size();
+    folderNamesSize += folder.size() + 1;
+    for (const QByteArray& file : files) {
+      fileNamesSize += file.size() + 1;
+    }
+  }
+
+  QByteArray data("BSA\0", 4);
+  append<quint32>(data, 105);
+  append<quint32>(data, 36);
+  append<quint32>(data, 0x3);
+  append<quint32>(data, folders.size());
+  append<quint32>(data, fileCount);
+  append<quint32>(data, folderNamesSize);
+  append<quint32>(data, fileNamesSize);
+  append<quint32>(data, 0);
+
+  for (const auto& [folder, files] : folders) {
+    append<quint64>(data, 0);
+    append<quint32>(data, files.size());
+    append<quint32>(data, 0);
+    append<quint64>(data, 0);
+  }
+
+  for (const auto& [folder, files] : folders) {
+    data.append(static_cast<char>(folder.size() + 1));
+    data.append(folder);
+    data.append('\0');
+    data.append(QByteArray(16 * files.size(), '\0'));
+  }
+
+  for (const auto& [folder, files] : folders) {
+    for (const QByteArray& file : files) {
+      data.append(file);
+      data.append('\0');
+    }
+  }
+
+  return data;
+}
+
+// Fallout 4 archive with the given files, the content is left out
+QByteArray ba2(const QList<QByteArray>& files)
+{
+  QByteArray data("BTDX", 4);
+  append<quint32>(data, 1);
+  data.append("GNRL", 4);
+  append<quint32>(data, files.size());
+  append<quint64>(data, 24);
+
+  for (const QByteArray& file : files) {
+    append<quint16>(data, file.size());
+    data.append(file);
+  }
+
+  return data;
+}
+
+}  // namespace
+
+TEST(ArchiveListingTest, ListsBsaFilesBelowDirectory)
+{
+  QTemporaryDir directory;
+  const QString path = directory.filePath("test.bsa");
+  write(path, bsa({{"textures\\a", {"x.dds", "Y.dds"}}, {"scripts", {"Foo.pex"}}}));
+
+  EXPECT_EQ(ArchiveListing::files(path, "Scripts\\"), QStringList{"scripts/foo.pex"});
+  EXPECT_EQ(ArchiveListing::files(path, "textures"),
+            (QStringList{"textures/a/x.dds", "textures/a/y.dds"}));
+  EXPECT_EQ(ArchiveListing::files(path, "")->size(), 3);
+  EXPECT_TRUE(ArchiveListing::files(path, "script")->isEmpty());
+}
+
+TEST(ArchiveListingTest, ListsBa2FilesBelowDirectory)
+{
+  QTemporaryDir directory;
+  const QString path = directory.filePath("test.ba2");
+  write(path, ba2({"Scripts\\Foo.pex", "meshes\\a.nif", "scripts\\source\\foo.psc"}));
+
+  EXPECT_EQ(ArchiveListing::files(path, "scripts"),
+            (QStringList{"scripts/foo.pex", "scripts/source/foo.psc"}));
+}
+
+TEST(ArchiveListingTest, RejectsOtherFiles)
+{
+  QTemporaryDir directory;
+  const QString path = directory.filePath("test.bsa");
+  write(path, "not an archive");
+
+  EXPECT_FALSE(ArchiveListing::files(path, "scripts"));
+  EXPECT_FALSE(ArchiveListing::files(directory.filePath("missing.bsa"), "scripts"));
+}
+
+TEST(ArchiveListingTest, RejectsTruncatedArchives)
+{
+  QTemporaryDir directory;
+  const QString path = directory.filePath("test.bsa");
+  write(path, bsa({{"scripts", {"foo.pex"}}}).chopped(4));
+
+  EXPECT_FALSE(ArchiveListing::files(path, "scripts"));
+}
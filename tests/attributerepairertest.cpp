@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "attributerepairer.h"
+#include "fakeattributebackend.h"
+
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+using Backend = FakeAttributeBackend;
+
+namespace
+{
+
+std::vector<QJsonObject> readLog(const QString& path)
+{
+  std::vector<QJsonObject> records;
+
+  QFile file(path);
+  if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    while (!file.atEnd()) {
+      records.push_back(QJsonDocument::fromJson(file.readLine()).object());
+    }
+  }
+  return records;
+}
+
+}  // namespace
+
+TEST(AttributeRepairerTest, RepairsAndLogsEveryChange)
+{
+  Backend backend;
+  backend.addFile("/data/locked.dds", Backend::ARCHIVE | Backend::READONLY);
+  backend.addFile("/data/packed.dds", Backend::COMPRESSED | Backend::SPARSE);
+
+  QTemporaryDir directory;
+  const QString log = directory.filePath("repair.log");
+  {
+    AttributeRepairer repairer(backend, log);
+    EXPECT_TRUE(repairer.repair({"/data/locked.dds", "/data/packed.dds"}).isEmpty());
+    EXPECT_EQ(repairer.processed().load(), 2);
+  }
+
+  EXPECT_EQ(backend.attributes("/data/locked.dds"), Backend::ARCHIVE);
+  EXPECT_EQ(backend.attributes("/data/packed.dds"), 0);
+
+  // the attributes of both files, then the compression and sparseness of one
+  const std::vector<QJsonObject> records = readLog(log);
+  ASSERT_EQ(records.size(), 4);
+  for (const QJsonObject& record : records) {
+    EXPECT_EQ(record["error"].toInteger(), 0);
+    EXPECT_FALSE(record["rollback"].toBool());
+  }
+}
+
+TEST(AttributeRepairerTest, RollsBackSession)
+{
+  Backend backend;
+  backend.addFile("/data/locked.dds", Backend::ARCHIVE | Backend::READONLY);
+  backend.addFile("/data/packed.dds", Backend::COMPRESSED | Backend::SPARSE);
+
+  QTemporaryDir directory;
+  const QString log = directory.filePath("repair.log");
+
+  QString session;
+  {
+    AttributeRepairer repairer(backend, log);
+    repairer.repair({"/data/locked.dds", "/data/packed.dds"});
+    session = repairer.session();
+  }
+
+  AttributeRepairer repairer(backend, log);
+  EXPECT_TRUE(repairer.rollback(session));
+  EXPECT_EQ(backend.attributes("/data/locked.dds"),
+            Backend::ARCHIVE | Backend::READONLY);
+  EXPECT_EQ(backend.attributes("/data/packed.dds"),
+            Backend::COMPRESSED | Backend::SPARSE);
+
+  int rollbacks = 0;
+  for (const QJsonObject& record : readLog(log)) {
+    rollbacks += record["rollback"].toBool() ? 1 : 0;
+  }
+  EXPECT_EQ(rollbacks, 4);
+}
+
+TEST(AttributeRepairerTest, ReportsRefusedChanges)
+{
+  Backend backend;
+  backend.addFile("/data/locked.dds", Backend::READONLY);
+  backend.addFile("/data/other.dds", Backend::READONLY);
+  backend.refuse("/data/locked.dds");
+
+  QTemporaryDir directory;
+  const QString log = directory.filePath("repair.log");
+  {
+    AttributeRepairer repairer(backend, log);
+    EXPECT_EQ(repairer.repair({"/data/locked.dds", "/data/other.dds"}),
+              QStringList{"/data/locked.dds"});
+  }
+
+  EXPECT_EQ(backend.attributes("/data/locked.dds"), Backend::READONLY);
+  EXPECT_EQ(backend.attributes("/data/other.dds"), 0);
+
+  // the attributes and the archive flag were both refused
+  int errors = 0;
+  for (const QJsonObject& record : readLog(log)) {
+    if (record["error"].toInteger() != 0) {
+      EXPECT_EQ(record["path"].toString(), "/data/locked.dds");
+      ++errors;
+    }
+  }
+  EXPECT_EQ(errors, 2);
+}
+
+TEST(AttributeRepairerTest, RollsBackPartiallyFailedSession)
+{
+  Backend backend;
+  backend.addFile("/data/locked.dds", Backend::READONLY);
+  backend.addFile("/data/other.dds", Backend::READONLY);
+  backend.refuse("/data/locked.dds");
+
+  QTemporaryDir directory;
+  AttributeRepairer repairer(backend, directory.filePath("repair.log"));
+  ASSERT_EQ(repairer.repair({"/data/locked.dds", "/data/other.dds"}).size(), 1);
+
+  // only the changes that were made are undone
+  EXPECT_TRUE(repairer.rollback(repairer.session()));
+  EXPECT_EQ(backend.attributes("/data/locked.dds"), Backend::READONLY);
+  EXPECT_EQ(backend.attributes("/data/other.dds"), Backend::READONLY);
+}
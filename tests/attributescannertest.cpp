@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "attributescanner.h"
+#include "fakeattributebackend.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+using Backend = FakeAttributeBackend;
+
+TEST(AttributeScannerTest, FindsProblematicEntries)
+{
+  Backend backend;
+  backend.addTree("/data", 3, 3, 4);
+  backend.addFile("/data/dir1/locked.dds", Backend::ARCHIVE | Backend::READONLY);
+  backend.addFile("/data/dir2/dir0/sparse.dds", Backend::SPARSE);
+
+  AttributeCache cache;
+  AttributeScanner scanner(backend);
+  EXPECT_EQ(scanner.scan({"/data"}, cache),
+            (QStringList{"/data/dir1/locked.dds", "/data/dir2/dir0/sparse.dds"}));
+
+  // the root and 3 + 9 subdirectories
+  EXPECT_EQ(scanner.scanned().load(), 13);
+  EXPECT_EQ(cache.size(), 13);
+}
+
+TEST(AttributeScannerTest, SkipsUnchangedDirectories)
+{
+  Backend backend;
+  backend.addTree("/data", 3, 3, 4);
+  backend.addFile("/data/dir1/locked.dds", Backend::ARCHIVE | Backend::READONLY);
+
+  AttributeCache cache;
+  AttributeScanner scanner(backend);
+  scanner.scan({"/data"}, cache);
+  EXPECT_EQ(backend.listings(), 13);
+
+  // only the directory that was not clean is listed again
+  EXPECT_EQ(scanner.scan({"/data"}, cache), QStringList{"/data/dir1/locked.dds"});
+  EXPECT_EQ(backend.listings(), 14);
+  EXPECT_EQ(scanner.skipped(), 12);
+}
+
+TEST(AttributeScannerTest, CanceledScanKeepsCache)
+{
+  Backend backend;
+  backend.addTree("/data", 2, 2, 2);
+
+  AttributeCache cache;
+  AttributeScanner scanner(backend);
+  scanner.scan({"/data"}, cache);
+  ASSERT_EQ(cache.size(), 3);
+
+  backend.addDirectory("/data/dir2");
+  scanner.cancel();
+  scanner.scan({"/data"}, cache);
+  EXPECT_EQ(cache.size(), 3);
+}
+
+TEST(AttributeScannerTest, WalksDiskWithPlatformBackend)
+{
+  QTemporaryDir root;
+  for (const char* directory : {"a/b/c", "a/d", "e"}) {
+    QDir(root.path()).mkpath(directory);
+  }
+
+  // the backend of the platform never finds problems in a fresh directory
+  auto backend = AttributeBackend::create();
+  AttributeCache cache;
+  AttributeScanner scanner(*backend);
+  EXPECT_TRUE(scanner.scan({root.path()}, cache).isEmpty());
+  EXPECT_EQ(scanner.scanned().load(), 6);
+}
+
+TEST(AttributeScannerTest, CacheIsKeptBetweenRuns)
+{
+  Backend backend;
+  backend.addTree("/data", 3, 3, 4);
+
+  QTemporaryDir directory;
+  const QString path = directory.filePath("attributes.cache");
+  {
+    AttributeCache cache;
+    AttributeScanner scanner(backend);
+    scanner.scan({"/data"}, cache);
+    ASSERT_TRUE(cache.save(path));
+  }
+
+  AttributeCache cache;
+  ASSERT_TRUE(cache.load(path));
+  EXPECT_EQ(cache.size(), 13);
+
+  AttributeScanner scanner(backend);
+  scanner.scan({"/data"}, cache);
+  EXPECT_EQ(scanner.skipped(), 13);
+}
+
+TEST(AttributeScannerTest, CorruptedCacheIsDiscarded)
+{
+  QTemporaryDir directory;
+  const QString path = directory.filePath("attributes.cache");
+  {
+    AttributeCache cache;
+    cache.insert("/data", {0, true, {}});
+    ASSERT_TRUE(cache.save(path));
+  }
+
+  // the count of directories claims far more than the file holds
+  QFile file(path);
+  ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+  file.seek(8);
+  QDataStream stream(&file);
+  stream << (quint64(1) << 60);
+  file.close();
+
+  AttributeCache cache;
+  EXPECT_FALSE(cache.load(path));
+  EXPECT_EQ(cache.size(), 0);
+}
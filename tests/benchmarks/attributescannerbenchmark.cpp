@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "attributescanner.h"
+#include "fakeattributebackend.h"
+#include "syntheticprofile.h"
+
+#include <QDir>
+#include <QTemporaryDir>
+
+#include <benchmark/benchmark.h>
+
+#include <functional>
+
+namespace
+{
+
+// directories per level and files per directory of the generated trees
+constexpr int DIRECTORIES = 8;
+constexpr int FILES       = 16;
+
+// a scan without a cache lists every directory
+void BM_ScanCold(benchmark::State& state)
+{
+  FakeAttributeBackend backend;
+  const int files =
+      backend.addTree("/data", static_cast<int>(state.range(0)), DIRECTORIES, FILES);
+
+  for (auto _ : state) {
+    AttributeCache cache;
+    AttributeScanner scanner(backend);
+    benchmark::DoNotOptimize(scanner.scan({"/data"}, cache));
+  }
+  state.SetItemsProcessed(state.iterations() * files);
+}
+
+// a scan with the cache of the previous one only probes the directories
+void BM_ScanWarm(benchmark::State& state)
+{
+  FakeAttributeBackend backend;
+  const int files =
+      backend.addTree("/data", static_cast<int>(state.range(0)), DIRECTORIES, FILES);
+
+  AttributeCache cache;
+  AttributeScanner(backend).scan({"/data"}, cache);
+  for (auto _ : state) {
+    AttributeScanner scanner(backend);
+    benchmark::DoNotOptimize(scanner.scan({"/data"}, cache));
+  }
+  state.SetItemsProcessed(state.iterations() * files);
+}
+
+// a scan of a tree on disk with the backend of the platform, the stub one on Linux
+void BM_ScanDisk(benchmark::State& state)
+{
+  QTemporaryDir root;
+  int files = 0;
+
+  // FILES files in every directory, DIRECTORIES subdirectories down to the depth
+  std::function<void(const QString&, int)> create = [&](const QString& path,
+                                                        int depth) {
+    QDir().mkpath(path);
+    for (int i = 0; i < FILES; ++i) {
+      SyntheticProfile::writeFile(QString("%1/file%2.dds").arg(path).arg(i));
+      ++files;
+    }
+    if (depth > 1) {
+      for (int i = 0; i < DIRECTORIES; ++i) {
+        create(QString("%1/dir%2").arg(path).arg(i), depth - 1);
+      }
+    }
+  };
+  create(root.path(), static_cast<int>(state.range(0)));
+
+  auto backend = AttributeBackend::create();
+  for (auto _ : state) {
+    AttributeCache cache;
+    AttributeScanner scanner(*backend);
+    benchmark::DoNotOptimize(scanner.scan({root.path()}, cache));
+  }
+  state.SetItemsProcessed(state.iterations() * files);
+}
+
+}  // namespace
+
+BENCHMARK(BM_ScanCold)->DenseRange(2, 4)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_ScanWarm)->DenseRange(2, 4)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_ScanDisk)->DenseRange(2, 4)->Unit(benchmark::kMillisecond)->UseRealTime();
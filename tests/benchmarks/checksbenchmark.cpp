@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "diagnosebasic.h"
+#include "syntheticprofile.h"
+
+#include <QApplication>
+
+#include <benchmark/benchmark.h>
+
+#include <map>
+#include <memory>
+#include <tuple>
+
+namespace
+{
+
+// settings enabling the checks, the profile tweaks check has no setting and always
+// runs
+const QStringList CHECK_SETTINGS{
+    "check_errorlog",   "check_overwrite",      "check_font",          "check_conflict",
+    "check_assetorder", "check_missingmasters", "check_alternategames"};
+
+// a profile with the plugin loaded and only the given checks enabled
+struct Instance
+{
+  Instance(const SyntheticProfile::Options& options, const QStringList& checks)
+      : profile(options)
+  {
+    FakeOrganizer& organizer = profile.organizer();
+    organizer.addDefaults(plugin.name(), plugin.settings());
+    for (const QString& setting : CHECK_SETTINGS) {
+      organizer.setPluginSetting(plugin.name(), setting, checks.contains(setting));
+    }
+    qApp->setProperty("dataPath", profile.basePath());
+    plugin.init(&organizer);
+  }
+
+  SyntheticProfile profile;
+  DiagnoseBasic plugin;
+};
+
+// the benchmark functions are called several times while the number of iterations
+// is estimated, the profiles are only generated once
+Instance& instance(const benchmark::State& state, const QStringList& checks)
+{
+  using Key = std::tuple<int, int, int, QStringList>;
+  static std::map<Key, std::unique_ptr<Instance>> instances;
+
+  const int mods    = static_cast<int>(state.range(0));
+  const int plugins = static_cast<int>(state.range(1));
+  const int files   = static_cast<int>(state.range(2));
+
+  std::unique_ptr<Instance>& result = instances[Key{mods, plugins, files, checks}];
+  if (!result) {
+    SyntheticProfile::Options options;
+    options.mods           = mods;
+    options.plugins        = plugins;
+    options.overwriteFiles = files;
+    options.overwriteDepth = 4;
+    options.missingMasters = plugins / 100;
+    result                 = std::make_unique<Instance>(options, checks);
+  }
+
+  qApp->setProperty("dataPath", result->profile.basePath());
+  return *result;
+}
+
+void setCounters(benchmark::State& state)
+{
+  state.counters["mods"]    = static_cast<double>(state.range(0));
+  state.counters["plugins"] = static_cast<double>(state.range(1));
+  state.counters["files"]   = static_cast<double>(state.range(2));
+}
+
+// a single check after all results have been invalidated, as after a profile change
+void BM_Check(benchmark::State& state, const char* setting)
+{
+  Instance& current = instance(state, {setting});
+  for (auto _ : state) {
+    current.profile.organizer().changeProfile();
+    benchmark::DoNotOptimize(current.plugin.activeProblems());
+  }
+  setCounters(state);
+}
+
+// every check after all results have been invalidated
+void BM_FullPass(benchmark::State& state)
+{
+  Instance& current = instance(state, CHECK_SETTINGS);
+  for (auto _ : state) {
+    current.profile.organizer().changeProfile();
+    benchmark::DoNotOptimize(current.plugin.activeProblems());
+  }
+  setCounters(state);
+}
+
+// every check with nothing changed since the last pass, only the uncached checks run
+void BM_CachedPass(benchmark::State& state)
+{
+  Instance& current = instance(state, CHECK_SETTINGS);
+  current.plugin.activeProblems();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(current.plugin.activeProblems());
+  }
+  setCounters(state);
+}
+
+// mods, plugins and files in the overwrite directory
+void profileSizes(benchmark::internal::Benchmark* benchmark)
+{
+  benchmark->Args({100, 500, 100})
+      ->Args({1000, 4000, 10000})
+      ->Unit(benchmark::kMillisecond)
+      ->UseRealTime();
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(BM_Check, errorlog, "check_errorlog")->Apply(profileSizes);
+BENCHMARK_CAPTURE(BM_Check, overwrite, "check_overwrite")->Apply(profileSizes);
+BENCHMARK_CAPTURE(BM_Check, font, "check_font")->Apply(profileSizes);
+BENCHMARK_CAPTURE(BM_Check, conflict, "check_conflict")->Apply(profileSizes);
+BENCHMARK_CAPTURE(BM_Check, assetorder, "check_assetorder")->Apply(profileSizes);
+BENCHMARK_CAPTURE(BM_Check, missingmasters, "check_missingmasters")
+    ->Apply(profileSizes);
+BENCHMARK_CAPTURE(BM_Check, alternategames, "check_alternategames")
+    ->Apply(profileSizes);
+BENCHMARK(BM_FullPass)->Apply(profileSizes);
+BENCHMARK(BM_CachedPass)->Apply(profileSizes);
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "diagnosebasic.h"
+#include "syntheticprofile.h"
+
+#include <QApplication>
+
+#include <benchmark/benchmark.h>
+
+#include <map>
+#include <memory>
+#include <tuple>
+
+namespace
+{
+
+// a profile whose overwrite directory holds only log files spread over a deep tree,
+// with the overwrite check as the only one enabled
+struct Instance
+{
+  Instance(int files, int depth, bool ignoreLog) : profile(options(files, depth))
+  {
+    FakeOrganizer& organizer = profile.organizer();
+    organizer.addDefaults(plugin.name(), plugin.settings());
+    for (const char* setting :
+         {"check_errorlog", "check_font", "check_conflict", "check_assetorder",
+          "check_missingmasters", "check_alternategames"}) {
+      organizer.setPluginSetting(plugin.name(), setting, false);
+    }
+    organizer.setPluginSetting(plugin.name(), "ow_ignore_log", ignoreLog);
+    qApp->setProperty("dataPath", profile.basePath());
+    plugin.init(&organizer);
+  }
+
+  static SyntheticProfile::Options options(int files, int depth)
+  {
+    SyntheticProfile::Options result;
+    result.mods           = 0;
+    result.plugins        = 0;
+    result.overwriteFiles = files;
+    result.overwriteDepth = depth;
+    result.overwriteLogs  = true;
+    return result;
+  }
+
+  SyntheticProfile profile;
+  DiagnoseBasic plugin;
+};
+
+Instance& instance(int files, int depth, bool ignoreLog)
+{
+  static std::map<std::tuple<int, int, bool>, std::unique_ptr<Instance>> instances;
+
+  auto& result = instances[{files, depth, ignoreLog}];
+  if (!result) {
+    result = std::make_unique<Instance>(files, depth, ignoreLog);
+  }
+
+  qApp->setProperty("dataPath", result->profile.basePath());
+  return *result;
+}
+
+// with ow_ignore_log, no file counts, so the streaming walk visits the whole tree
+void BM_OverwriteWalkAll(benchmark::State& state)
+{
+  const int files = static_cast<int>(state.range(0));
+  const int depth = static_cast<int>(state.range(1));
+
+  Instance& current = instance(files, depth, true);
+  for (auto _ : state) {
+    // a finished run is what invalidates the check in MO
+    current.profile.organizer().finishRun("tool.exe", 0);
+    benchmark::DoNotOptimize(current.plugin.activeProblems());
+  }
+  state.SetItemsProcessed(state.iterations() * files);
+}
+
+// without the setting, the walk stops at the first file it finds
+void BM_OverwriteWalkFirst(benchmark::State& state)
+{
+  const int files = static_cast<int>(state.range(0));
+  const int depth = static_cast<int>(state.range(1));
+
+  Instance& current = instance(files, depth, false);
+  for (auto _ : state) {
+    current.profile.organizer().finishRun("tool.exe", 0);
+    benchmark::DoNotOptimize(current.plugin.activeProblems());
+  }
+}
+
+// files and depth of the tree
+void treeSizes(benchmark::internal::Benchmark* benchmark)
+{
+  benchmark->Args({10000, 1})
+      ->Args({10000, 8})
+      ->Args({10000, 32})
+      ->Args({100000, 8})
+      ->Unit(benchmark::kMillisecond)
+      ->UseRealTime();
+}
+
+}  // namespace
+
+BENCHMARK(BM_OverwriteWalkAll)->Apply(treeSizes);
+BENCHMARK(BM_OverwriteWalkFirst)->Apply(treeSizes);
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "fakepluginlist.h"
+#include "plugingraph.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <map>
+#include <set>
+
+using namespace MOBase;
+
+namespace
+{
+
+// plugins requiring the three plugins before them, one in a hundred also requires a
+// master that is not installed and one in fifty is inactive
+void fill(FakePluginList& plugins, int count)
+{
+  QStringList names;
+  for (int i = 0; i < count; ++i) {
+    const QString name = QString("Plugin %1.esp").arg(i, 5, 10, QChar('0'));
+
+    QStringList masters;
+    for (int j = std::max(0, i - 3); j < i; ++j) {
+      masters.append(names[j].toUpper());
+    }
+    if (i % 100 == 99) {
+      masters.append(QString("Missing %1.esm").arg(i));
+    }
+
+    plugins.add(FakePluginList::Plugin{name, "mod", masters, i % 50 != 49, false});
+    names.append(name);
+  }
+}
+
+// the lookup the plugin graph replaced: lowered names of the active plugins in a set,
+// and a lowered copy of every master to look it up
+bool naiveMissingMasters(const IPluginList& plugins,
+                         std::map<QString, std::set<QString>>& children)
+{
+  const QStringList names = plugins.pluginNames();
+
+  std::set<QString> enabledPlugins;
+  for (const QString& name : names) {
+    if (plugins.state(name) == IPluginList::STATE_ACTIVE) {
+      enabledPlugins.insert(name.toLower());
+    }
+  }
+
+  children.clear();
+  for (const QString& name : names) {
+    if (plugins.state(name) != IPluginList::STATE_ACTIVE) {
+      continue;
+    }
+    for (const QString& master : plugins.masters(name)) {
+      if (enabledPlugins.find(master.toLower()) == enabledPlugins.end()) {
+        children[master].insert(name);
+      }
+    }
+  }
+  return !children.empty();
+}
+
+void BM_NaiveMissingMasters(benchmark::State& state)
+{
+  FakePluginList plugins;
+  fill(plugins, static_cast<int>(state.range(0)));
+
+  std::map<QString, std::set<QString>> children;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(naiveMissingMasters(plugins, children));
+  }
+}
+
+// the analysis on a graph that is kept up to date by the callbacks
+void BM_PluginGraphProblems(benchmark::State& state)
+{
+  FakePluginList plugins;
+  fill(plugins, static_cast<int>(state.range(0)));
+
+  PluginGraph graph;
+  graph.rebuild(&plugins);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(graph.problems());
+  }
+}
+
+// the analysis along with a rebuild, as after a refresh of the plugin list
+void BM_PluginGraphRebuild(benchmark::State& state)
+{
+  FakePluginList plugins;
+  fill(plugins, static_cast<int>(state.range(0)));
+
+  PluginGraph graph;
+  for (auto _ : state) {
+    graph.rebuild(&plugins);
+    benchmark::DoNotOptimize(graph.problems());
+  }
+}
+
+}  // namespace
+
+BENCHMARK(BM_NaiveMissingMasters)->Arg(4000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_PluginGraphProblems)->Arg(4000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_PluginGraphRebuild)->Arg(4000)->Unit(benchmark::kMicrosecond);
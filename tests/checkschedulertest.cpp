@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "checkscheduler.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+TEST(CheckSchedulerTest, CollectsTheResults)
+{
+  std::atomic<int> finished = 0;
+  CheckScheduler scheduler;
+  scheduler.onCheckFinished([&finished](unsigned int) {
+    ++finished;
+  });
+
+  scheduler.start(2, []() {
+    return false;
+  });
+  scheduler.start(1, []() {
+    return true;
+  });
+  scheduler.start(3, []() -> bool {
+    throw std::runtime_error("failed");
+  });
+
+  // a failed check has no problem to report
+  EXPECT_EQ(scheduler.wait(5000ms),
+            (std::map<unsigned int, bool>{{1, true}, {2, false}, {3, false}}));
+  EXPECT_FALSE(scheduler.isRunning(1));
+  EXPECT_FALSE(scheduler.hasFinished());
+
+  // the callback runs on the worker once the result is set
+  for (int i = 0; i < 500 && finished < 3; ++i) {
+    std::this_thread::sleep_for(10ms);
+  }
+  EXPECT_EQ(finished, 3);
+}
+
+TEST(CheckSchedulerTest, KeepsChecksThatTimeOutRunning)
+{
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  std::atomic<int> started          = 0;
+
+  CheckScheduler scheduler;
+  const auto check = [&started, released]() {
+    ++started;
+    released.wait();
+    return true;
+  };
+  scheduler.start(1, check);
+
+  EXPECT_TRUE(scheduler.wait(20ms).empty());
+  EXPECT_TRUE(scheduler.isRunning(1));
+
+  // the running check is not started a second time, its result is collected by the
+  // next wait instead
+  scheduler.start(1, check);
+  release.set_value();
+  EXPECT_EQ(scheduler.wait(5000ms), (std::map<unsigned int, bool>{{1, true}}));
+  EXPECT_FALSE(scheduler.isRunning(1));
+  EXPECT_EQ(started, 1);
+}
+
+TEST(CheckSchedulerTest, ZeroTimeoutOnlyCollectsFinishedChecks)
+{
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+
+  CheckScheduler scheduler;
+  scheduler.start(1, [released]() {
+    released.wait();
+    return true;
+  });
+
+  EXPECT_TRUE(scheduler.wait(0ms).empty());
+  EXPECT_FALSE(scheduler.hasFinished());
+
+  release.set_value();
+  for (int i = 0; i < 500 && !scheduler.hasFinished(); ++i) {
+    std::this_thread::sleep_for(10ms);
+  }
+  ASSERT_TRUE(scheduler.hasFinished());
+  EXPECT_EQ(scheduler.wait(0ms), (std::map<unsigned int, bool>{{1, true}}));
+  EXPECT_TRUE(scheduler.wait(0ms).empty());
+}
@@ -0,0 +1,264 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "diagnosebasic.h"
+#include "syntheticprofile.h"
+
+#include <QApplication>
+#include <QFileInfo>
+#include <QTest>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+
+using namespace MOBase;
+
+namespace
+{
+
+// keys of the problems, as reported by the plugin
+constexpr unsigned int PROBLEM_OVERWRITE      = 2;
+constexpr unsigned int PROBLEM_ASSETORDER     = 5;
+constexpr unsigned int PROBLEM_MISSINGMASTERS = 8;
+constexpr unsigned int PROBLEM_PERFORMANCE    = 10;
+
+class DiagnoseBasicTest : public ::testing::Test
+{
+protected:
+  void load(const SyntheticProfile::Options& options)
+  {
+    m_Profile = std::make_unique<SyntheticProfile>(options);
+    m_Plugin  = std::make_unique<DiagnoseBasic>();
+
+    qApp->setProperty("dataPath", m_Profile->basePath());
+    m_Profile->organizer().addDefaults(m_Plugin->name(), m_Plugin->settings());
+    ASSERT_TRUE(m_Plugin->init(&m_Profile->organizer()));
+  }
+
+  bool reports(unsigned int key) const
+  {
+    const std::vector<unsigned int> problems = m_Plugin->activeProblems();
+    return std::find(problems.begin(), problems.end(), key) != problems.end();
+  }
+
+  void setSetting(const QString& key, const QVariant& value)
+  {
+    m_Profile->organizer().setPluginSetting(m_Plugin->name(), key, value);
+  }
+
+  // writes an archive of the given plugin packing the given scripts to its mod
+  void writeScripts(const QString& mod, const QString& plugin,
+                    const QStringList& scripts)
+  {
+    QStringList files;
+    for (const QString& script : scripts) {
+      files.append("scripts\\" + script + ".pex");
+    }
+    SyntheticProfile::writeArchive(m_Profile->basePath() + "/mods/" + mod + "/" +
+                                       QFileInfo(plugin).completeBaseName() +
+                                       " - Main.ba2",
+                                   files);
+  }
+
+  // the last cell of each row of the timings table for the given check, most recent
+  // run first
+  QStringList cacheHits(const QString& check) const
+  {
+    QStringList hits;
+    const QString description = m_Plugin->fullDescription(PROBLEM_PERFORMANCE);
+    for (const QString& row : description.split(QString("<tr>"))) {
+      if (!row.contains(">" + check + "</td>")) {
+        continue;
+      }
+      const QString cells = row.left(row.lastIndexOf("</td>"));
+      hits.append(cells.mid(cells.lastIndexOf('>') + 1));
+    }
+    return hits;
+  }
+
+  std::unique_ptr<SyntheticProfile> m_Profile;
+  std::unique_ptr<DiagnoseBasic> m_Plugin;
+};
+
+}  // namespace
+
+TEST_F(DiagnoseBasicTest, CleanProfileHasNoProblems)
+{
+  load({.mods = 10, .plugins = 20});
+
+  EXPECT_TRUE(m_Plugin->activeProblems().empty());
+}
+
+TEST_F(DiagnoseBasicTest, ReportsOverwriteFiles)
+{
+  load({.mods = 10, .plugins = 20, .overwriteFiles = 3});
+
+  EXPECT_TRUE(reports(PROBLEM_OVERWRITE));
+}
+
+TEST_F(DiagnoseBasicTest, IgnoresOverwriteLogsWhenConfigured)
+{
+  load({.mods           = 10,
+        .plugins        = 20,
+        .overwriteFiles = 3,
+        .overwriteDepth = 4,
+        .overwriteLogs  = true});
+  EXPECT_TRUE(reports(PROBLEM_OVERWRITE));
+
+  setSetting("ow_ignore_log", true);
+  EXPECT_FALSE(reports(PROBLEM_OVERWRITE));
+}
+
+TEST_F(DiagnoseBasicTest, DisabledCheckIsNotReported)
+{
+  load({.mods = 10, .plugins = 20, .overwriteFiles = 3});
+  EXPECT_TRUE(reports(PROBLEM_OVERWRITE));
+
+  setSetting("check_overwrite", false);
+  EXPECT_FALSE(reports(PROBLEM_OVERWRITE));
+}
+
+TEST_F(DiagnoseBasicTest, OverwriteIsWalkedAgainWhileItIsNotWatched)
+{
+  // the directory is only watched once the user interface is up
+  load({.mods = 10, .plugins = 20});
+  EXPECT_FALSE(reports(PROBLEM_OVERWRITE));
+
+  SyntheticProfile::writeFile(m_Profile->organizer().overwritePath() + "/new.txt");
+  EXPECT_TRUE(reports(PROBLEM_OVERWRITE));
+}
+
+TEST_F(DiagnoseBasicTest, DescribesTheOverwriteContentFoundByTheCheck)
+{
+  load({.mods = 10, .plugins = 20});
+  SyntheticProfile::writeFile(m_Profile->organizer().overwritePath() + "/SKSE/new.txt");
+
+  ASSERT_TRUE(reports(PROBLEM_OVERWRITE));
+  EXPECT_TRUE(m_Plugin->fullDescription(PROBLEM_OVERWRITE).contains("holds 1 files"));
+  EXPECT_TRUE(m_Plugin->fullDescription(PROBLEM_OVERWRITE).contains("SKSE"));
+}
+
+TEST_F(DiagnoseBasicTest, WatchedOverwriteIsReportedOnceItChanges)
+{
+  load({.mods = 10, .plugins = 20});
+  m_Profile->organizer().initializeUserInterface();
+  EXPECT_FALSE(reports(PROBLEM_OVERWRITE));
+
+  SyntheticProfile::writeFile(m_Profile->organizer().overwritePath() + "/new.txt");
+  bool reported = false;
+  for (int i = 0; i < 250 && !reported; ++i) {
+    QTest::qWait(20);
+    reported = reports(PROBLEM_OVERWRITE);
+  }
+  EXPECT_TRUE(reported);
+}
+
+TEST_F(DiagnoseBasicTest, ReportsMastersThatAreNotInstalled)
+{
+  load({.mods = 10, .plugins = 20, .missingMasters = 1});
+
+  EXPECT_TRUE(reports(PROBLEM_MISSINGMASTERS));
+  EXPECT_TRUE(
+      m_Plugin->fullDescription(PROBLEM_MISSINGMASTERS).contains("Missing 00000.esm"));
+}
+
+TEST_F(DiagnoseBasicTest, FollowsPluginStateChanges)
+{
+  load({.mods = 10, .plugins = 20});
+  EXPECT_FALSE(reports(PROBLEM_MISSINGMASTERS));
+
+  m_Profile->pluginList().setState("Plugin 00000.esp", IPluginList::STATE_INACTIVE);
+  EXPECT_TRUE(reports(PROBLEM_MISSINGMASTERS));
+
+  m_Profile->pluginList().setState("Plugin 00000.esp", IPluginList::STATE_ACTIVE);
+  EXPECT_FALSE(reports(PROBLEM_MISSINGMASTERS));
+}
+
+TEST_F(DiagnoseBasicTest, CountsThePluginGraphAsCachedOnlyOnceItIsReused)
+{
+  load({.mods = 10, .plugins = 20});
+  setSetting("show_check_timings", true);
+
+  // the first pass builds the graph, the second one reuses the updated graph
+  EXPECT_FALSE(reports(PROBLEM_MISSINGMASTERS));
+  m_Profile->pluginList().setState("Plugin 00000.esp", IPluginList::STATE_INACTIVE);
+  EXPECT_TRUE(reports(PROBLEM_MISSINGMASTERS));
+  EXPECT_EQ(cacheHits("missingmasters"), QStringList({"1", "0"}));
+}
+
+TEST_F(DiagnoseBasicTest, AssetOrderLeavesGroupsThatLoadInOrder)
+{
+  load({.mods = 2, .plugins = 3, .mastersPerPlugin = 0});
+  setSetting("check_assetorder", true);
+
+  // the last plugin is only tied to the group through the first one, which comes from
+  // the same mod, so it is not constrained
+  writeScripts("Mod 00000", "Plugin 00000.esp", {"a", "b"});
+  writeScripts("Mod 00001", "Plugin 00001.esp", {"a"});
+  writeScripts("Mod 00000", "Plugin 00002.esp", {"b"});
+
+  EXPECT_FALSE(reports(PROBLEM_ASSETORDER));
+}
+
+TEST_F(DiagnoseBasicTest, AssetOrderFixKeepsUnconstrainedPlugins)
+{
+  load({.mods = 3, .plugins = 4, .mastersPerPlugin = 0});
+  setSetting("check_assetorder", true);
+
+  // the last plugin comes from the same mod as the first one and only shares scripts
+  // with it, nothing constrains it so it keeps its place at the end
+  writeScripts("Mod 00000", "Plugin 00000.esp", {"a", "c"});
+  writeScripts("Mod 00001", "Plugin 00001.esp", {"a", "b"});
+  writeScripts("Mod 00002", "Plugin 00002.esp", {"b"});
+  writeScripts("Mod 00000", "Plugin 00003.esp", {"c"});
+
+  m_Profile->modList().setPriority("Mod 00001", 0);
+  ASSERT_TRUE(reports(PROBLEM_ASSETORDER));
+
+  m_Plugin->startGuidedFix(PROBLEM_ASSETORDER);
+  const FakePluginList& plugins = m_Profile->pluginList();
+  EXPECT_LT(plugins.priority("Plugin 00001.esp"), plugins.priority("Plugin 00000.esp"));
+  EXPECT_LT(plugins.priority("Plugin 00000.esp"), plugins.priority("Plugin 00002.esp"));
+  EXPECT_LT(plugins.priority("Plugin 00002.esp"), plugins.priority("Plugin 00003.esp"));
+  EXPECT_FALSE(reports(PROBLEM_ASSETORDER));
+}
+
+TEST_F(DiagnoseBasicTest, FixesTheAssetOrder)
+{
+  load({.mods = 3, .plugins = 3, .mastersPerPlugin = 0});
+  setSetting("check_assetorder", true);
+
+  writeScripts("Mod 00000", "Plugin 00000.esp", {"a"});
+  writeScripts("Mod 00001", "Plugin 00001.esp", {"a", "b"});
+  writeScripts("Mod 00002", "Plugin 00002.esp", {"b"});
+  EXPECT_FALSE(reports(PROBLEM_ASSETORDER));
+
+  // the second mod now has the lowest priority, but its plugin still loads after the
+  // first one so its scripts win
+  m_Profile->modList().setPriority("Mod 00001", 0);
+  ASSERT_TRUE(reports(PROBLEM_ASSETORDER));
+
+  m_Plugin->startGuidedFix(PROBLEM_ASSETORDER);
+  const FakePluginList& plugins = m_Profile->pluginList();
+  EXPECT_LT(plugins.priority("Plugin 00001.esp"), plugins.priority("Plugin 00000.esp"));
+  EXPECT_LT(plugins.priority("Plugin 00001.esp"), plugins.priority("Plugin 00002.esp"));
+  EXPECT_FALSE(reports(PROBLEM_ASSETORDER));
+}
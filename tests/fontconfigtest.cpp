@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "fontconfig.h"
+
+#include <gtest/gtest.h>
+
+TEST(FontConfigTest, ParsesDirectives)
+{
+  const QByteArray data   = "\xEF\xBB\xBF"
+                            "fontlib \"Interface\\fonts_en.swf\"\r\n"
+                            "map \"$ConsoleFont\" = \"Arial\" Normal\n"
+                            "map \"$StartMenuFont\" = \"Futura\"\n"
+                            "validNameChars \"$EverywhereFont\" \"abc\"\n"
+                            "unknown directive\n";
+  const FontConfig config = FontConfig::parse(data);
+
+  ASSERT_EQ(config.libraries().size(), 1);
+  EXPECT_EQ(config.libraries()[0].line, 1);
+  EXPECT_EQ(config.libraries()[0].path, "Interface\\fonts_en.swf");
+
+  ASSERT_EQ(config.mappings().size(), 2);
+  EXPECT_EQ(config.mappings()[0].alias, "$ConsoleFont");
+  EXPECT_EQ(config.mappings()[0].font, "Arial");
+  EXPECT_EQ(config.mappings()[1].line, 3);
+  EXPECT_EQ(config.mappings()[1].font, "Futura");
+
+  ASSERT_EQ(config.nameChars().size(), 1);
+  EXPECT_EQ(config.nameChars()[0].alias, "$EverywhereFont");
+
+  EXPECT_TRUE(config.malformed().empty());
+}
+
+TEST(FontConfigTest, ReportsMalformedDirectives)
+{
+  const FontConfig config = FontConfig::parse("fontlib Interface\\fonts_en.swf\n"
+                                              "map \"$ConsoleFont\" \"Arial\"\n"
+                                              "fontlib \"Interface\\fonts_en.swf\n");
+
+  ASSERT_EQ(config.malformed().size(), 3);
+  EXPECT_EQ(config.malformed()[0].line, 1);
+  EXPECT_EQ(config.malformed()[1].text, "map \"$ConsoleFont\" \"Arial\"");
+  EXPECT_EQ(config.malformed()[2].line, 3);
+  EXPECT_TRUE(config.libraries().empty());
+  EXPECT_TRUE(config.mappings().empty());
+}
+
+TEST(FontConfigTest, ParsesEscapedQuotesInNameChars)
+{
+  // the line shipped with the game lists the quote and the backslash escaped
+  const FontConfig config = FontConfig::parse(
+      "validNameChars \"$EverywhereFont\" \" !\\\"#$%&'()*+,-./0123456789:;<=>?@"
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\\\]^_`abcdefghijklmnopqrstuvwxyz{|}~\"\n"
+      "fontlib \"Interface\\fonts_console.swf\"\n");
+
+  ASSERT_EQ(config.nameChars().size(), 1);
+  EXPECT_EQ(config.nameChars()[0].alias, "$EverywhereFont");
+  ASSERT_EQ(config.libraries().size(), 1);
+  EXPECT_EQ(config.libraries()[0].path, "Interface\\fonts_console.swf");
+  EXPECT_TRUE(config.malformed().empty());
+}
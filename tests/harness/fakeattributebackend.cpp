@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "fakeattributebackend.h"
+
+class FakeAttributeBackend::Handle : public AttributeHandle
+{
+public:
+  Handle(const FakeAttributeBackend& backend, const QString& path)
+      : m_Backend(backend), m_Path(path)
+  {}
+
+  std::uint32_t setCompressed(bool compressed) override
+  {
+    return m_Backend.setFlag(m_Path, COMPRESSED, compressed);
+  }
+
+  std::uint32_t setSparse(bool sparse) override
+  {
+    return m_Backend.setFlag(m_Path, SPARSE, sparse);
+  }
+
+private:
+  const FakeAttributeBackend& m_Backend;
+  QString m_Path;
+};
+
+void FakeAttributeBackend::addDirectory(const QString& path, std::int64_t modified)
+{
+  std::scoped_lock lock(m_Mutex);
+
+  // the missing parents are added first so that each can be linked to its own
+  QStringList missing;
+  QString current = path;
+  while (!current.isEmpty() && !m_Nodes.contains(current)) {
+    missing.prepend(current);
+    current = parentOf(current);
+  }
+
+  for (const QString& directory : missing) {
+    m_Nodes.insert(directory, Node{DIRECTORY, modified, {}});
+    const QString parent = parentOf(directory);
+    if (!parent.isEmpty()) {
+      m_Nodes[parent].children.append(directory);
+    }
+  }
+}
+
+void FakeAttributeBackend::addFile(const QString& path, std::uint32_t attributes,
+                                   std::int64_t modified)
+{
+  const QString parent = parentOf(path);
+  addDirectory(parent, modified);
+
+  std::scoped_lock lock(m_Mutex);
+  m_Nodes.insert(path, Node{attributes, modified, {}});
+  m_Nodes[parent].children.append(path);
+}
+
+int FakeAttributeBackend::addTree(const QString& root, int depth, int directories,
+                                  int files)
+{
+  addDirectory(root);
+
+  int count = 0;
+  for (int i = 0; i < files; ++i) {
+    addFile(QString("%1/file%2.dds").arg(root).arg(i));
+    ++count;
+  }
+  if (depth > 1) {
+    for (int i = 0; i < directories; ++i) {
+      count +=
+          addTree(QString("%1/dir%2").arg(root).arg(i), depth - 1, directories, files);
+    }
+  }
+  return count;
+}
+
+void FakeAttributeBackend::refuse(const QString& path)
+{
+  std::scoped_lock lock(m_Mutex);
+  m_Refused.insert(path);
+}
+
+std::uint32_t FakeAttributeBackend::attributes(const QString& path) const
+{
+  std::scoped_lock lock(m_Mutex);
+  return m_Nodes.value(path).attributes;
+}
+
+int FakeAttributeBackend::listings() const
+{
+  std::scoped_lock lock(m_Mutex);
+  return m_Listings;
+}
+
+bool FakeAttributeBackend::list(const QString& directory,
+                                std::vector<AttributeEntry>& entries) const
+{
+  std::scoped_lock lock(m_Mutex);
+  auto iter = m_Nodes.constFind(directory);
+  if (iter == m_Nodes.constEnd() || !(iter->attributes & DIRECTORY)) {
+    return false;
+  }
+
+  ++m_Listings;
+  for (const QString& child : iter->children) {
+    entries.push_back(toEntry(child, m_Nodes[child]));
+  }
+  return true;
+}
+
+std::optional<AttributeEntry> FakeAttributeBackend::probe(const QString& path) const
+{
+  std::scoped_lock lock(m_Mutex);
+  auto iter = m_Nodes.constFind(path);
+  if (iter == m_Nodes.constEnd()) {
+    return {};
+  }
+  return toEntry(path, *iter);
+}
+
+bool FakeAttributeBackend::isProblematic(std::uint32_t attributes) const
+{
+  return attributes & (READONLY | SPARSE | COMPRESSED | OFFLINE);
+}
+
+QString FakeAttributeBackend::describe(std::uint32_t attributes,
+                                       const QString& path) const
+{
+  return QString("%1 %2").arg(attributes, 8, 16, QLatin1Char('0')).arg(path);
+}
+
+AttributeRepair FakeAttributeBackend::planRepair(std::uint32_t attributes) const
+{
+  return AttributeRepair{attributes & ~(READONLY | SPARSE | COMPRESSED | OFFLINE),
+                         (attributes & COMPRESSED) != 0, (attributes & SPARSE) != 0};
+}
+
+std::uint32_t FakeAttributeBackend::withArchive(std::uint32_t attributes) const
+{
+  return attributes | ARCHIVE;
+}
+
+std::uint32_t FakeAttributeBackend::setAttributes(const QString& path,
+                                                  std::uint32_t attributes) const
+{
+  std::scoped_lock lock(m_Mutex);
+  auto iter = m_Nodes.find(path);
+  if (iter == m_Nodes.end() || m_Refused.contains(path)) {
+    return ACCESS_DENIED;
+  }
+
+  // compression and sparseness cannot be changed this way
+  const std::uint32_t kept = iter->attributes & (SPARSE | COMPRESSED);
+  iter->attributes         = (attributes & ~(SPARSE | COMPRESSED)) | kept;
+  return 0;
+}
+
+std::unique_ptr<AttributeHandle> FakeAttributeBackend::open(const QString& path,
+                                                            std::uint32_t& error) const
+{
+  std::scoped_lock lock(m_Mutex);
+  if (!m_Nodes.contains(path) || m_Refused.contains(path)) {
+    error = ACCESS_DENIED;
+    return nullptr;
+  }
+  return std::make_unique<Handle>(*this, path);
+}
+
+QString FakeAttributeBackend::parentOf(const QString& path)
+{
+  const qsizetype separator = path.lastIndexOf('/');
+  return separator <= 0 ? QString() : path.left(separator);
+}
+
+AttributeEntry FakeAttributeBackend::toEntry(const QString& path,
+                                             const Node& node) const
+{
+  return AttributeEntry{path, node.attributes, node.modified,
+                        (node.attributes & DIRECTORY) != 0};
+}
+
+std::uint32_t FakeAttributeBackend::setFlag(const QString& path, std::uint32_t flag,
+                                            bool set) const
+{
+  std::scoped_lock lock(m_Mutex);
+  auto iter = m_Nodes.find(path);
+  if (iter == m_Nodes.end()) {
+    return ACCESS_DENIED;
+  }
+
+  if (set) {
+    iter->attributes |= flag;
+  } else {
+    iter->attributes &= ~flag;
+  }
+  return 0;
+}
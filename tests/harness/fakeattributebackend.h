@@ -0,0 +1,102 @@
+/*
+Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+
+This file is part of basic diagnosis plugin for MO
+
+This plugin is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This plugin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef FAKEATTRIBUTEBACKEND_H
+#define FAKEATTRIBUTEBACKEND_H
+
+#include "attributebackend.h"
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include <mutex>
+
+// in-memory tree of files with Windows-like attributes, so the scanner and the
+// repairer can be tested and measured on any platform
+//
+// every change is applied to the tree, paths listed in the failures are refused
+class FakeAttributeBackend : public AttributeBackend
+{
+public:
+  static constexpr std::uint32_t READONLY   = 0x1;
+  static constexpr std::uint32_t DIRECTORY  = 0x10;
+  static constexpr std::uint32_t ARCHIVE    = 0x20;
+  static constexpr std::uint32_t SPARSE     = 0x200;
+  static constexpr std::uint32_t COMPRESSED = 0x800;
+  static constexpr std::uint32_t OFFLINE    = 0x1000;
+
+  // error returned for the refused changes
+  static constexpr std::uint32_t ACCESS_DENIED = 5;
+
+  // adds a directory or a file, its parent directories are added as needed
+  void addDirectory(const QString& path, std::int64_t modified = 0);
+  void addFile(const QString& path, std::uint32_t attributes = ARCHIVE,
+               std::int64_t modified = 0);
+
+  // builds a tree of the given depth with the given number of subdirectories and
+  // files per directory, returns the number of files
+  int addTree(const QString& root, int depth, int directories, int files);
+
+  // changes of the attributes of the given path are refused
+  void refuse(const QString& path);
+
+  // current attributes of the given path
+  std::uint32_t attributes(const QString& path) const;
+
+  // number of directories listed so far
+  int listings() const;
+
+  QString nativePath(const QString& path) const override { return path; }
+  bool list(const QString& directory,
+            std::vector<AttributeEntry>& entries) const override;
+  std::optional<AttributeEntry> probe(const QString& path) const override;
+  bool isProblematic(std::uint32_t attributes) const override;
+  QString describe(std::uint32_t attributes, const QString& path) const override;
+  AttributeRepair planRepair(std::uint32_t attributes) const override;
+  std::uint32_t withArchive(std::uint32_t attributes) const override;
+  std::uint32_t setAttributes(const QString& path,
+                              std::uint32_t attributes) const override;
+  std::unique_ptr<AttributeHandle> open(const QString& path,
+                                        std::uint32_t& error) const override;
+
+private:
+  struct Node
+  {
+    std::uint32_t attributes;
+    std::int64_t modified;
+    QStringList children;
+  };
+
+  class Handle;
+
+  static QString parentOf(const QString& path);
+  AttributeEntry toEntry(const QString& path, const Node& node) const;
+
+  // changes a flag that is only accessible through a handle
+  std::uint32_t setFlag(const QString& path, std::uint32_t flag, bool set) const;
+
+  mutable std::mutex m_Mutex;
+  mutable QHash<QString, Node> m_Nodes;
+  QSet<QString> m_Refused;
+  mutable int m_Listings = 0;
+};
+
+#endif  // FAKEATTRIBUTEBACKEND_H
@@ -0,0 +1,107 @@
+/*
+Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+
+This file is part of basic diagnosis plugin for MO
+
+This plugin is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This plugin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef FAKEGAME_H
+#define FAKEGAME_H
+
+#include <QDir>
+#include <QIcon>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+
+#include <uibase/executableinfo.h>
+#include <uibase/iplugingame.h>
+#include <uibase/isavegame.h>
+
+// managed game of the fake organizer, only the names, the data directory and the
+// mod mappings are used by the plugin
+class FakeGame : public MOBase::IPluginGame
+{
+public:
+  FakeGame(const QString& gameName, const QString& shortName, const QString& dataPath)
+      : m_GameName(gameName), m_ShortName(shortName), m_DataPath(dataPath)
+  {}
+
+  // directories of a mod that are mapped to other places than the data directory
+  void setModMappings(const QMap<QString, QStringList>& mappings)
+  {
+    m_Mappings = mappings;
+  }
+
+  // IPlugin
+  bool init(MOBase::IOrganizer*) override { return true; }
+  QString name() const override { return "Fake Game"; }
+  QString author() const override { return {}; }
+  QString description() const override { return {}; }
+  MOBase::VersionInfo version() const override { return {}; }
+  QList<MOBase::PluginSetting> settings() const override { return {}; }
+
+  // IPluginGame
+  QString gameName() const override { return m_GameName; }
+  QString gameShortName() const override { return m_ShortName; }
+  QDir dataDirectory() const override { return QDir(m_DataPath); }
+  QDir gameDirectory() const override { return QDir(m_DataPath + "/.."); }
+  QMap<QString, QStringList> getModMappings() const override { return m_Mappings; }
+
+  void detectGame() override {}
+  QList<MOBase::ExecutableInfo> executables() const override { return {}; }
+  QList<MOBase::ExecutableForcedLoadSetting> executableForcedLoads() const override
+  {
+    return {};
+  }
+  QIcon gameIcon() const override { return {}; }
+  void setGamePath(const QString&) override {}
+  QDir documentsDirectory() const override { return gameDirectory(); }
+  QDir savesDirectory() const override { return gameDirectory(); }
+  std::vector<std::shared_ptr<const MOBase::ISaveGame>> listSaves(QDir) const override
+  {
+    return {};
+  }
+  bool isInstalled() const override { return true; }
+  void initializeProfile(const QDir&, ProfileSettings) const override {}
+  QStringList gameVariants() const override { return {}; }
+  void setGameVariant(const QString&) override {}
+  QString binaryName() const override { return {}; }
+  QStringList validShortNames() const override { return {}; }
+  QStringList primarySources() const override { return {}; }
+  QStringList primaryPlugins() const override { return {}; }
+  QStringList iniFiles() const override { return {}; }
+  QStringList DLCPlugins() const override { return {}; }
+  QStringList CCPlugins() const override { return {}; }
+  LoadOrderMechanism loadOrderMechanism() const override
+  {
+    return LoadOrderMechanism::PluginsTxt;
+  }
+  SortMechanism sortMechanism() const override { return SortMechanism::NONE; }
+  int nexusModOrganizerID() const override { return 0; }
+  int nexusGameID() const override { return 0; }
+  bool looksValid(const QDir&) const override { return true; }
+  QString gameVersion() const override { return {}; }
+  QString getLauncherName() const override { return {}; }
+  QString steamAPPId() const override { return {}; }
+
+private:
+  QString m_GameName;
+  QString m_ShortName;
+  QString m_DataPath;
+  QMap<QString, QStringList> m_Mappings;
+};
+
+#endif  // FAKEGAME_H
@@ -0,0 +1,101 @@
+/*
+Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+
+This file is part of basic diagnosis plugin for MO
+
+This plugin is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This plugin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef FAKEMOD_H
+#define FAKEMOD_H
+
+#include <QColor>
+#include <QString>
+#include <QStringList>
+
+#include <uibase/imodinterface.h>
+
+// mod of the fake mod list, only the name and the directory are real
+class FakeMod : public MOBase::IModInterface
+{
+public:
+  FakeMod(const QString& name, const QString& path) : m_Name(name), m_Path(path) {}
+
+  QString name() const override { return m_Name; }
+  QString absolutePath() const override { return m_Path; }
+
+  QString comments() const override { return {}; }
+  QString notes() const override { return {}; }
+  QString gameName() const override { return {}; }
+  QString repository() const override { return {}; }
+  int nexusId() const override { return 0; }
+  MOBase::VersionInfo version() const override { return {}; }
+  MOBase::VersionInfo newestVersion() const override { return {}; }
+  MOBase::VersionInfo ignoredVersion() const override { return {}; }
+  QString installationFile() const override { return {}; }
+  std::set<std::pair<int, int>> installedFiles() const override { return {}; }
+  bool converted() const override { return false; }
+  bool validated() const override { return false; }
+  QColor color() const override { return {}; }
+  QString url() const override { return {}; }
+  int primaryCategory() const override { return -1; }
+  QStringList categories() const override { return {}; }
+  MOBase::TrackedState trackedState() const override
+  {
+    return MOBase::TrackedState::TRACKED_FALSE;
+  }
+  MOBase::EndorsedState endorsedState() const override
+  {
+    return MOBase::EndorsedState::ENDORSED_NEVER;
+  }
+  std::shared_ptr<const MOBase::IFileTree> fileTree() const override { return nullptr; }
+  bool isOverwrite() const override { return false; }
+  bool isBackup() const override { return false; }
+  bool isSeparator() const override { return false; }
+  bool isForeign() const override { return false; }
+
+  void setVersion(const MOBase::VersionInfo&) override {}
+  void setNewestVersion(const MOBase::VersionInfo&) override {}
+  void setIsEndorsed(bool) override {}
+  void setNexusID(int) override {}
+  void addNexusCategory(int) override {}
+  bool addCategory(const QString&) override { return false; }
+  bool removeCategory(const QString&) override { return false; }
+  void setGameName(const QString&) override {}
+  void setUrl(const QString&) override {}
+
+  QVariant pluginSetting(const QString&, const QString&,
+                         const QVariant& defaultValue) const override
+  {
+    return defaultValue;
+  }
+  std::map<QString, QVariant> pluginSettings(const QString&) const override
+  {
+    return {};
+  }
+  bool setPluginSetting(const QString&, const QString&, const QVariant&) override
+  {
+    return false;
+  }
+  std::map<QString, QVariant> clearPluginSettings(const QString&) override
+  {
+    return {};
+  }
+
+private:
+  QString m_Name;
+  QString m_Path;
+};
+
+#endif  // FAKEMOD_H
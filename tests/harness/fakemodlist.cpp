@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "fakemodlist.h"
+
+using namespace MOBase;
+
+void FakeModList::add(const QString& name, const QString& path, bool active)
+{
+  m_Index.insert(name, static_cast<int>(m_Mods.size()));
+  m_Mods.push_back(Mod{std::make_unique<FakeMod>(name, path), active});
+}
+
+void FakeModList::install(const QString& name, const QString& path)
+{
+  add(name, path, false);
+  for (const auto& callback : m_Installed) {
+    callback(m_Mods.back().mod.get());
+  }
+}
+
+QString FakeModList::displayName(const QString& internalName) const
+{
+  return internalName;
+}
+
+QStringList FakeModList::allMods() const
+{
+  // MO does not list the mods by priority either
+  QStringList names;
+  for (const Mod& mod : m_Mods) {
+    names.append(mod.mod->name());
+  }
+  names.sort(Qt::CaseInsensitive);
+  return names;
+}
+
+QStringList FakeModList::allModsByProfilePriority(IProfile*) const
+{
+  QStringList names;
+  for (const Mod& mod : m_Mods) {
+    names.append(mod.mod->name());
+  }
+  return names;
+}
+
+IModInterface* FakeModList::getMod(const QString& name) const
+{
+  const int index = find(name);
+  return index < 0 ? nullptr : m_Mods[index].mod.get();
+}
+
+bool FakeModList::removeMod(IModInterface* mod)
+{
+  const int index = find(mod->name());
+  if (index < 0) {
+    return false;
+  }
+
+  const QString name = mod->name();
+  m_Mods.erase(m_Mods.begin() + index);
+  reindex();
+  for (const auto& callback : m_Removed) {
+    callback(name);
+  }
+  return true;
+}
+
+IModInterface* FakeModList::renameMod(IModInterface*, const QString&)
+{
+  return nullptr;
+}
+
+IModList::ModStates FakeModList::state(const QString& name) const
+{
+  const int index = find(name);
+  if (index < 0) {
+    return {};
+  }
+
+  ModStates states = STATE_EXISTS | STATE_VALID;
+  if (m_Mods[index].active) {
+    states |= STATE_ACTIVE;
+  }
+  return states;
+}
+
+bool FakeModList::setActive(const QString& name, bool active)
+{
+  return setActive(QStringList{name}, active) == 1;
+}
+
+int FakeModList::setActive(const QStringList& names, bool active)
+{
+  std::map<QString, ModStates> changed;
+  for (const QString& name : names) {
+    const int index = find(name);
+    if (index >= 0 && m_Mods[index].active != active) {
+      m_Mods[index].active = active;
+      changed[name]        = state(name);
+    }
+  }
+
+  if (!changed.empty()) {
+    for (const auto& callback : m_StateChanged) {
+      callback(changed);
+    }
+  }
+  return static_cast<int>(changed.size());
+}
+
+int FakeModList::priority(const QString& name) const
+{
+  return find(name);
+}
+
+bool FakeModList::setPriority(const QString& name, int newPriority)
+{
+  const int index = find(name);
+  if (index < 0 || newPriority < 0 || newPriority >= static_cast<int>(m_Mods.size())) {
+    return false;
+  }
+
+  Mod mod = std::move(m_Mods[index]);
+  m_Mods.erase(m_Mods.begin() + index);
+  m_Mods.insert(m_Mods.begin() + newPriority, std::move(mod));
+  reindex();
+  for (const auto& callback : m_Moved) {
+    callback(name, index, newPriority);
+  }
+  return true;
+}
+
+bool FakeModList::onModInstalled(const std::function<void(IModInterface*)>& func)
+{
+  m_Installed.push_back(func);
+  return true;
+}
+
+bool FakeModList::onModRemoved(const std::function<void(const QString&)>& func)
+{
+  m_Removed.push_back(func);
+  return true;
+}
+
+bool FakeModList::onModStateChanged(
+    const std::function<void(const std::map<QString, ModStates>&)>& func)
+{
+  m_StateChanged.push_back(func);
+  return true;
+}
+
+bool FakeModList::onModMoved(const std::function<void(const QString&, int, int)>& func)
+{
+  m_Moved.push_back(func);
+  return true;
+}
+
+int FakeModList::find(const QString& name) const
+{
+  return m_Index.value(name, -1);
+}
+
+void FakeModList::reindex()
+{
+  m_Index.clear();
+  for (std::size_t i = 0; i < m_Mods.size(); ++i) {
+    m_Index.insert(m_Mods[i].mod->name(), static_cast<int>(i));
+  }
+}
@@ -0,0 +1,89 @@
+/*
+Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+
+This file is part of basic diagnosis plugin for MO
+
+This plugin is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This plugin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef FAKEMODLIST_H
+#define FAKEMODLIST_H
+
+#include "fakemod.h"
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+#include <uibase/imodlist.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+// in-memory mod list, the callbacks registered by the plugin are called by the
+// functions that change the list
+class FakeModList : public MOBase::IModList
+{
+public:
+  // appends a mod with the lowest priority, the directory is not created
+  void add(const QString& name, const QString& path, bool active);
+
+  // adds a mod and notifies as MO does after an installation
+  void install(const QString& name, const QString& path);
+
+  QString displayName(const QString& internalName) const override;
+  QStringList allMods() const override;
+  QStringList allModsByProfilePriority(MOBase::IProfile* profile) const override;
+  MOBase::IModInterface* getMod(const QString& name) const override;
+  bool removeMod(MOBase::IModInterface* mod) override;
+  MOBase::IModInterface* renameMod(MOBase::IModInterface* mod,
+                                   const QString& name) override;
+  ModStates state(const QString& name) const override;
+  bool setActive(const QString& name, bool active) override;
+  int setActive(const QStringList& names, bool active) override;
+  int priority(const QString& name) const override;
+  bool setPriority(const QString& name, int newPriority) override;
+
+  bool onModInstalled(const std::function<void(MOBase::IModInterface*)>& func) override;
+  bool onModRemoved(const std::function<void(const QString&)>& func) override;
+  bool onModStateChanged(
+      const std::function<void(const std::map<QString, ModStates>&)>& func) override;
+  bool onModMoved(const std::function<void(const QString&, int, int)>& func) override;
+
+private:
+  struct Mod
+  {
+    std::unique_ptr<FakeMod> mod;
+    bool active;
+  };
+
+  // index of the given mod in m_Mods, which is also its priority, or -1
+  int find(const QString& name) const;
+  void reindex();
+
+  std::vector<Mod> m_Mods;
+
+  // the plugin queries every mod by name, a lookup must not be the bottleneck of a
+  // benchmark
+  QHash<QString, int> m_Index;
+
+  std::vector<std::function<void(MOBase::IModInterface*)>> m_Installed;
+  std::vector<std::function<void(const QString&)>> m_Removed;
+  std::vector<std::function<void(const std::map<QString, ModStates>&)>> m_StateChanged;
+  std::vector<std::function<void(const QString&, int, int)>> m_Moved;
+};
+
+#endif  // FAKEMODLIST_H
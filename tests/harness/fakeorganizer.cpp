@@ -0,0 +1,205 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "fakeorganizer.h"
+
+#include <QDir>
+#include <QFileInfo>
+
+using namespace MOBase;
+
+FakeOrganizer::FakeOrganizer(const QString& basePath, FakeModList& mods,
+                             FakePluginList& plugins, FakeGame& game)
+    : m_BasePath(basePath), m_Mods(mods), m_Plugins(plugins), m_Game(game)
+{}
+
+void FakeOrganizer::addDefaults(const QString& pluginName,
+                                const QList<PluginSetting>& settings)
+{
+  for (const PluginSetting& setting : settings) {
+    const QString key = pluginName + "/" + setting.key;
+    if (!m_Settings.contains(key)) {
+      m_Settings.insert(key, setting.defaultValue);
+    }
+  }
+}
+
+void FakeOrganizer::initializeUserInterface()
+{
+  for (const auto& callback : m_UserInterfaceInitialized) {
+    callback(nullptr);
+  }
+}
+
+void FakeOrganizer::changeProfile()
+{
+  for (const auto& callback : m_ProfileChanged) {
+    callback(nullptr, nullptr);
+  }
+}
+
+bool FakeOrganizer::aboutToRun(const QString& executable)
+{
+  for (const auto& callback : m_AboutToRun) {
+    if (!callback(executable)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void FakeOrganizer::finishRun(const QString& executable, unsigned int exitCode)
+{
+  for (const auto& callback : m_FinishedRun) {
+    callback(executable, exitCode);
+  }
+}
+
+QString FakeOrganizer::profilePath() const
+{
+  return m_BasePath + "/profiles/Default";
+}
+
+QString FakeOrganizer::downloadsPath() const
+{
+  return m_BasePath + "/downloads";
+}
+
+QString FakeOrganizer::overwritePath() const
+{
+  return m_BasePath + "/overwrite";
+}
+
+QString FakeOrganizer::modsPath() const
+{
+  return m_BasePath + "/mods";
+}
+
+Version FakeOrganizer::version() const
+{
+  return Version(2, 5, 0);
+}
+
+QVariant FakeOrganizer::pluginSetting(const QString& pluginName,
+                                      const QString& key) const
+{
+  return m_Settings.value(pluginName + "/" + key);
+}
+
+void FakeOrganizer::setPluginSetting(const QString& pluginName, const QString& key,
+                                     const QVariant& value)
+{
+  const QVariant old = m_Settings.value(pluginName + "/" + key);
+  m_Settings.insert(pluginName + "/" + key, value);
+  for (const auto& callback : m_PluginSettingChanged) {
+    callback(pluginName, key, old, value);
+  }
+}
+
+QVariant FakeOrganizer::persistent(const QString& pluginName, const QString& key,
+                                   const QVariant& def) const
+{
+  return m_Persistent.value(pluginName + "/" + key, def);
+}
+
+void FakeOrganizer::setPersistent(const QString& pluginName, const QString& key,
+                                  const QVariant& value, bool)
+{
+  m_Persistent.insert(pluginName + "/" + key, value);
+}
+
+QString FakeOrganizer::pluginDataPath() const
+{
+  return m_BasePath + "/plugins/data";
+}
+
+QString FakeOrganizer::resolvePath(const QString& fileName) const
+{
+  auto resolve = [&](const QString& directory) {
+    const QString path = QDir(directory).filePath(fileName);
+    return QFileInfo::exists(path) ? path : QString();
+  };
+
+  if (QString path = resolve(overwritePath()); !path.isEmpty()) {
+    return path;
+  }
+
+  const QStringList mods = m_Mods.allModsByProfilePriority(nullptr);
+  for (auto it = mods.rbegin(); it != mods.rend(); ++it) {
+    if (!m_Mods.state(*it).testFlag(IModList::STATE_ACTIVE)) {
+      continue;
+    }
+    if (QString path = resolve(m_Mods.getMod(*it)->absolutePath()); !path.isEmpty()) {
+      return path;
+    }
+  }
+
+  return resolve(m_Game.dataDirectory().absolutePath());
+}
+
+bool FakeOrganizer::onAboutToRun(const std::function<bool(const QString&)>& func)
+{
+  m_AboutToRun.push_back(func);
+  return true;
+}
+
+bool FakeOrganizer::onAboutToRun(
+    const std::function<bool(const QString&, const QDir&, const QString&)>& func)
+{
+  m_AboutToRun.push_back([func](const QString& executable) {
+    return func(executable, QDir(), QString());
+  });
+  return true;
+}
+
+bool FakeOrganizer::onFinishedRun(
+    const std::function<void(const QString&, unsigned int)>& func)
+{
+  m_FinishedRun.push_back(func);
+  return true;
+}
+
+bool FakeOrganizer::onUserInterfaceInitialized(
+    const std::function<void(QMainWindow*)>& func)
+{
+  m_UserInterfaceInitialized.push_back(func);
+  return true;
+}
+
+bool FakeOrganizer::onNextRefresh(const std::function<void()>& func, bool)
+{
+  // there is no refresh in progress
+  func();
+  return true;
+}
+
+bool FakeOrganizer::onProfileChanged(
+    const std::function<void(IProfile*, IProfile*)>& func)
+{
+  m_ProfileChanged.push_back(func);
+  return true;
+}
+
+bool FakeOrganizer::onPluginSettingChanged(
+    const std::function<void(const QString&, const QString&, const QVariant&,
+                             const QVariant&)>& func)
+{
+  m_PluginSettingChanged.push_back(func);
+  return true;
+}
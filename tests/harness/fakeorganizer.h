@@ -0,0 +1,184 @@
+/*
+Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+
+This file is part of basic diagnosis plugin for MO
+
+This plugin is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This plugin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef FAKEORGANIZER_H
+#define FAKEORGANIZER_H
+
+#include "fakegame.h"
+#include "fakemodlist.h"
+#include "fakepluginlist.h"
+
+#include <QHash>
+#include <QString>
+#include <QVariant>
+
+#include <uibase/imoinfo.h>
+
+#include <functional>
+#include <vector>
+
+// organizer running on in-memory lists and a directory of the test, the callbacks
+// registered by the plugin are called by the functions simulating the events
+//
+// paths are resolved against the overwrite directory and the active mods, highest
+// priority first, then the data directory of the game
+class FakeOrganizer : public MOBase::IOrganizer
+{
+public:
+  FakeOrganizer(const QString& basePath, FakeModList& mods, FakePluginList& plugins,
+                FakeGame& game);
+
+  // sets the settings of the given plugin that have no value yet to their default
+  void addDefaults(const QString& pluginName,
+                   const QList<MOBase::PluginSetting>& settings);
+
+  // events
+  void initializeUserInterface();
+  void changeProfile();
+  bool aboutToRun(const QString& executable);
+  void finishRun(const QString& executable, unsigned int exitCode);
+
+  QString profileName() const override { return "Default"; }
+  QString profilePath() const override;
+  QString downloadsPath() const override;
+  QString overwritePath() const override;
+  QString basePath() const override { return m_BasePath; }
+  QString modsPath() const override;
+  MOBase::VersionInfo appVersion() const override { return {}; }
+  MOBase::Version version() const override;
+  MOBase::IModInterface* createMod(MOBase::GuessedValue<QString>&) override
+  {
+    return nullptr;
+  }
+  MOBase::IPluginGame* getGame(const QString&) const override { return &m_Game; }
+  void modDataChanged(MOBase::IModInterface*) override {}
+  bool isPluginEnabled(const QString&) const override { return true; }
+  bool isPluginEnabled(MOBase::IPlugin*) const override { return true; }
+  QVariant pluginSetting(const QString& pluginName, const QString& key) const override;
+  void setPluginSetting(const QString& pluginName, const QString& key,
+                        const QVariant& value) override;
+  QVariant persistent(const QString& pluginName, const QString& key,
+                      const QVariant& def) const override;
+  void setPersistent(const QString& pluginName, const QString& key,
+                     const QVariant& value, bool sync) override;
+  QString pluginDataPath() const override;
+  MOBase::IModInterface* installMod(const QString&, const QString&) override
+  {
+    return nullptr;
+  }
+  QString resolvePath(const QString& fileName) const override;
+  QStringList listDirectories(const QString&) const override { return {}; }
+  QStringList findFiles(const QString&,
+                        const std::function<bool(const QString&)>&) const override
+  {
+    return {};
+  }
+  QStringList findFiles(const QString&, const QStringList&) const override
+  {
+    return {};
+  }
+  QStringList getFileOrigins(const QString&) const override { return {}; }
+  QList<FileInfo>
+  findFileInfos(const QString&,
+                const std::function<bool(const FileInfo&)>&) const override
+  {
+    return {};
+  }
+  std::shared_ptr<const MOBase::IFileTree> virtualFileTree() const override
+  {
+    return nullptr;
+  }
+  MOBase::IDownloadManager* downloadManager() const override { return nullptr; }
+  MOBase::IPluginList* pluginList() const override { return &m_Plugins; }
+  MOBase::IModList* modList() const override { return &m_Mods; }
+  MOBase::IProfile* profile() const override { return nullptr; }
+  MOBase::IGameFeatures* gameFeatures() const override { return nullptr; }
+  HANDLE startApplication(const QString&, const QStringList&, const QString&,
+                          const QString&, const QString&, bool) override
+  {
+    return nullptr;
+  }
+  bool waitForApplication(HANDLE, bool, LPDWORD) const override { return false; }
+  void refresh(bool) override { m_Plugins.refresh(); }
+  const MOBase::IPluginGame* managedGame() const override { return &m_Game; }
+
+  bool onAboutToRun(const std::function<bool(const QString&)>& func) override;
+  bool onAboutToRun(const std::function<bool(const QString&, const QDir&,
+                                             const QString&)>& func) override;
+  bool
+  onFinishedRun(const std::function<void(const QString&, unsigned int)>& func) override;
+  bool
+  onUserInterfaceInitialized(const std::function<void(QMainWindow*)>& func) override;
+  bool onNextRefresh(const std::function<void()>& func, bool immediateIfReady) override;
+  bool onProfileCreated(const std::function<void(MOBase::IProfile*)>&) override
+  {
+    return true;
+  }
+  bool onProfileRenamed(const std::function<void(MOBase::IProfile*, const QString&,
+                                                 const QString&)>&) override
+  {
+    return true;
+  }
+  bool onProfileRemoved(const std::function<void(const QString&)>&) override
+  {
+    return true;
+  }
+  bool onProfileChanged(
+      const std::function<void(MOBase::IProfile*, MOBase::IProfile*)>& func) override;
+  bool onPluginSettingChanged(
+      const std::function<void(const QString&, const QString&, const QVariant&,
+                               const QVariant&)>& func) override;
+  bool onPluginEnabled(const std::function<void(const MOBase::IPlugin*)>&) override
+  {
+    return true;
+  }
+  bool onPluginEnabled(const QString&, const std::function<void()>&) override
+  {
+    return true;
+  }
+  bool onPluginDisabled(const std::function<void(const MOBase::IPlugin*)>&) override
+  {
+    return true;
+  }
+  bool onPluginDisabled(const QString&, const std::function<void()>&) override
+  {
+    return true;
+  }
+
+private:
+  QString m_BasePath;
+  FakeModList& m_Mods;
+  FakePluginList& m_Plugins;
+  FakeGame& m_Game;
+
+  // keyed by plugin name and setting separated by a slash
+  QHash<QString, QVariant> m_Settings;
+  QHash<QString, QVariant> m_Persistent;
+
+  std::vector<std::function<bool(const QString&)>> m_AboutToRun;
+  std::vector<std::function<void(const QString&, unsigned int)>> m_FinishedRun;
+  std::vector<std::function<void(QMainWindow*)>> m_UserInterfaceInitialized;
+  std::vector<std::function<void(MOBase::IProfile*, MOBase::IProfile*)>>
+      m_ProfileChanged;
+  std::vector<std::function<void(const QString&, const QString&, const QVariant&,
+                                 const QVariant&)>>
+      m_PluginSettingChanged;
+};
+
+#endif  // FAKEORGANIZER_H
@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "fakepluginlist.h"
+
+using namespace MOBase;
+
+void FakePluginList::add(const Plugin& plugin)
+{
+  m_Index.insert(plugin.name.toLower(), static_cast<int>(m_Plugins.size()));
+  m_Plugins.push_back(plugin);
+}
+
+void FakePluginList::refresh()
+{
+  for (const auto& callback : m_Refreshed) {
+    callback();
+  }
+}
+
+QStringList FakePluginList::pluginNames() const
+{
+  QStringList names;
+  names.reserve(m_Plugins.size());
+  for (const Plugin& plugin : m_Plugins) {
+    names.append(plugin.name);
+  }
+  return names;
+}
+
+IPluginList::PluginStates FakePluginList::state(const QString& name) const
+{
+  const Plugin* plugin = find(name);
+  if (plugin == nullptr) {
+    return STATE_MISSING;
+  }
+  return plugin->active ? STATE_ACTIVE : STATE_INACTIVE;
+}
+
+void FakePluginList::setState(const QString& name, PluginStates state)
+{
+  auto iter = m_Index.constFind(name.toLower());
+  if (iter == m_Index.constEnd()) {
+    return;
+  }
+
+  Plugin& plugin = m_Plugins[*iter];
+  plugin.active  = state == STATE_ACTIVE;
+  for (const auto& callback : m_StateChanged) {
+    callback({{plugin.name, state}});
+  }
+}
+
+int FakePluginList::priority(const QString& name) const
+{
+  return m_Index.value(name.toLower(), -1);
+}
+
+bool FakePluginList::setPriority(const QString& name, int newPriority)
+{
+  const int oldPriority = priority(name);
+  if (oldPriority < 0 || newPriority < 0 ||
+      newPriority >= static_cast<int>(m_Plugins.size())) {
+    return false;
+  }
+
+  Plugin plugin = std::move(m_Plugins[oldPriority]);
+  m_Plugins.erase(m_Plugins.begin() + oldPriority);
+  m_Plugins.insert(m_Plugins.begin() + newPriority, std::move(plugin));
+  reindex();
+
+  for (const auto& callback : m_Moved) {
+    callback(m_Plugins[newPriority].name, oldPriority, newPriority);
+  }
+  return true;
+}
+
+int FakePluginList::loadOrder(const QString& name) const
+{
+  const Plugin* plugin = find(name);
+  return plugin != nullptr && plugin->active ? priority(name) : -1;
+}
+
+void FakePluginList::setLoadOrder(const QStringList& pluginList)
+{
+  // plugins that are not listed keep their relative order after the listed ones
+  std::vector<Plugin> ordered;
+  std::vector<bool> placed(m_Plugins.size(), false);
+  for (const QString& name : pluginList) {
+    const int index = priority(name);
+    if (index >= 0 && !placed[index]) {
+      ordered.push_back(m_Plugins[index]);
+      placed[index] = true;
+    }
+  }
+  for (std::size_t i = 0; i < m_Plugins.size(); ++i) {
+    if (!placed[i]) {
+      ordered.push_back(m_Plugins[i]);
+    }
+  }
+
+  m_Plugins = std::move(ordered);
+  reindex();
+}
+
+bool FakePluginList::isMaster(const QString& name) const
+{
+  return isMasterFlagged(name);
+}
+
+QStringList FakePluginList::masters(const QString& name) const
+{
+  const Plugin* plugin = find(name);
+  return plugin != nullptr ? plugin->masters : QStringList();
+}
+
+QString FakePluginList::origin(const QString& name) const
+{
+  const Plugin* plugin = find(name);
+  return plugin != nullptr ? plugin->origin : QString();
+}
+
+bool FakePluginList::hasMasterExtension(const QString& name) const
+{
+  return name.endsWith(".esm", Qt::CaseInsensitive);
+}
+
+bool FakePluginList::hasLightExtension(const QString& name) const
+{
+  return name.endsWith(".esl", Qt::CaseInsensitive);
+}
+
+bool FakePluginList::isMasterFlagged(const QString& name) const
+{
+  const Plugin* plugin = find(name);
+  return plugin != nullptr && plugin->masterFlagged;
+}
+
+bool FakePluginList::isMediumFlagged(const QString&) const
+{
+  return false;
+}
+
+bool FakePluginList::isLightFlagged(const QString&) const
+{
+  return false;
+}
+
+bool FakePluginList::isBlueprintFlagged(const QString&) const
+{
+  return false;
+}
+
+bool FakePluginList::hasNoRecords(const QString&) const
+{
+  return false;
+}
+
+int FakePluginList::formVersion(const QString&) const
+{
+  return 44;
+}
+
+float FakePluginList::headerVersion(const QString&) const
+{
+  return 1.7f;
+}
+
+QString FakePluginList::author(const QString&) const
+{
+  return {};
+}
+
+QString FakePluginList::description(const QString&) const
+{
+  return {};
+}
+
+bool FakePluginList::onRefreshed(const std::function<void()>& callback)
+{
+  m_Refreshed.push_back(callback);
+  return true;
+}
+
+bool FakePluginList::onPluginMoved(
+    const std::function<void(const QString&, int, int)>& func)
+{
+  m_Moved.push_back(func);
+  return true;
+}
+
+bool FakePluginList::onPluginStateChanged(
+    const std::function<void(const std::map<QString, PluginStates>&)>& func)
+{
+  m_StateChanged.push_back(func);
+  return true;
+}
+
+const FakePluginList::Plugin* FakePluginList::find(const QString& name) const
+{
+  auto iter = m_Index.constFind(name.toLower());
+  return iter == m_Index.constEnd() ? nullptr : &m_Plugins[*iter];
+}
+
+void FakePluginList::reindex()
+{
+  m_Index.clear();
+  for (std::size_t i = 0; i < m_Plugins.size(); ++i) {
+    m_Index.insert(m_Plugins[i].name.toLower(), static_cast<int>(i));
+  }
+}
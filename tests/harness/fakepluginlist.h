@@ -0,0 +1,96 @@
+/*
+Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+
+This file is part of basic diagnosis plugin for MO
+
+This plugin is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This plugin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef FAKEPLUGINLIST_H
+#define FAKEPLUGINLIST_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+#include <uibase/ipluginlist.h>
+
+#include <functional>
+#include <map>
+#include <vector>
+
+// in-memory plugin list, the callbacks registered by the plugin are called by the
+// functions that change the list
+class FakePluginList : public MOBase::IPluginList
+{
+public:
+  struct Plugin
+  {
+    QString name;
+    QString origin;
+    QStringList masters;
+    bool active        = true;
+    bool masterFlagged = false;
+  };
+
+  // appends a plugin with the lowest priority
+  void add(const Plugin& plugin);
+
+  // notifies as MO does after the plugin list has been read again
+  void refresh();
+
+  QStringList pluginNames() const override;
+  PluginStates state(const QString& name) const override;
+  void setState(const QString& name, PluginStates state) override;
+  int priority(const QString& name) const override;
+  bool setPriority(const QString& name, int newPriority) override;
+  int loadOrder(const QString& name) const override;
+  void setLoadOrder(const QStringList& pluginList) override;
+  bool isMaster(const QString& name) const override;
+  QStringList masters(const QString& name) const override;
+  QString origin(const QString& name) const override;
+  bool hasMasterExtension(const QString& name) const override;
+  bool hasLightExtension(const QString& name) const override;
+  bool isMasterFlagged(const QString& name) const override;
+  bool isMediumFlagged(const QString& name) const override;
+  bool isLightFlagged(const QString& name) const override;
+  bool isBlueprintFlagged(const QString& name) const override;
+  bool hasNoRecords(const QString& name) const override;
+  int formVersion(const QString& name) const override;
+  float headerVersion(const QString& name) const override;
+  QString author(const QString& name) const override;
+  QString description(const QString& name) const override;
+
+  bool onRefreshed(const std::function<void()>& callback) override;
+  bool
+  onPluginMoved(const std::function<void(const QString&, int, int)>& func) override;
+  bool onPluginStateChanged(
+      const std::function<void(const std::map<QString, PluginStates>&)>& func) override;
+
+private:
+  // the plugin with the given name, the lookup is case-insensitive like in MO
+  const Plugin* find(const QString& name) const;
+  void reindex();
+
+  // ordered by priority
+  std::vector<Plugin> m_Plugins;
+  QHash<QString, int> m_Index;
+
+  std::vector<std::function<void()>> m_Refreshed;
+  std::vector<std::function<void(const QString&, int, int)>> m_Moved;
+  std::vector<std::function<void(const std::map<QString, PluginStates>&)>>
+      m_StateChanged;
+};
+
+#endif  // FAKEPLUGINLIST_H
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "syntheticprofile.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QtEndian>
+
+#include <algorithm>
+
+SyntheticProfile::SyntheticProfile(const Options& options)
+{
+  const QString root = m_Root.path();
+  for (const char* directory :
+       {"overwrite", "profiles/Default", "logs", "game/Data", "plugins/data"}) {
+    QDir(root).mkpath(directory);
+  }
+
+  m_Game = std::make_unique<FakeGame>("Skyrim Special Edition", "SkyrimSE",
+                                      root + "/game/Data");
+
+  m_Organizer = std::make_unique<FakeOrganizer>(root, m_Mods, m_Plugins, *m_Game);
+
+  QStringList mods;
+  for (int i = 0; i < options.mods; ++i) {
+    const QString name = QString("Mod %1").arg(i, 5, 10, QChar('0'));
+    const QString path = root + "/mods/" + name;
+    QDir().mkpath(path);
+    m_Mods.add(name, path, true);
+    mods.append(name);
+  }
+
+  QStringList plugins;
+  for (int i = 0; i < options.plugins; ++i) {
+    const QString name = QString("Plugin %1.esp").arg(i, 5, 10, QChar('0'));
+
+    QStringList masters;
+    for (int j = std::max(0, i - options.mastersPerPlugin); j < i; ++j) {
+      masters.append(plugins[j]);
+    }
+    if (i < options.missingMasters) {
+      masters.append(QString("Missing %1.esm").arg(i, 5, 10, QChar('0')));
+    }
+
+    const QString mod = mods.isEmpty() ? QString() : mods[i % mods.size()];
+    const QString directory =
+        mod.isEmpty() ? m_Game->dataDirectory().absolutePath() : root + "/mods/" + mod;
+    writePlugin(directory + "/" + name, masters);
+
+    m_Plugins.add(FakePluginList::Plugin{name, mod, masters, true, false});
+    plugins.append(name);
+  }
+
+  const QString extension = options.overwriteLogs ? ".log" : ".txt";
+  for (int i = 0; i < options.overwriteFiles; ++i) {
+    QString directory = QString("%1/overwrite/output%2").arg(root).arg(i % 16);
+    for (int level = 1; level < options.overwriteDepth; ++level) {
+      directory += QString("/level%1").arg(level);
+    }
+    writeFile(QString("%1/file%2%3").arg(directory).arg(i).arg(extension));
+  }
+}
+
+void SyntheticProfile::writePlugin(const QString& path, const QStringList& masters)
+{
+  auto subrecord = [](const char* type, const QByteArray& data) {
+    QByteArray result(type, 4);
+    char size[2];
+    qToLittleEndian<quint16>(static_cast<quint16>(data.size()), size);
+    result.append(size, 2);
+    result.append(data);
+    return result;
+  };
+
+  // version 1.7 with no records
+  QByteArray subrecords = subrecord("HEDR", QByteArray(12, '\0'));
+  for (const QString& master : masters) {
+    subrecords += subrecord("MAST", master.toLatin1() + '\0');
+    subrecords += subrecord("DATA", QByteArray(8, '\0'));
+  }
+
+  QByteArray record("TES4", 4);
+  char size[4];
+  qToLittleEndian<quint32>(static_cast<quint32>(subrecords.size()), size);
+  record.append(size, 4);
+  record.append(QByteArray(16, '\0'));
+  record.append(subrecords);
+
+  QFile file(path);
+  if (file.open(QIODevice::WriteOnly)) {
+    file.write(record);
+  }
+}
+
+void SyntheticProfile::writeFile(const QString& path, qint64 size)
+{
+  QDir().mkpath(QFileInfo(path).absolutePath());
+
+  QFile file(path);
+  if (file.open(QIODevice::WriteOnly)) {
+    file.write(QByteArray(size, 'x'));
+  }
+}
+
+void SyntheticProfile::writeArchive(const QString& path, const QStringList& files)
+{
+  QByteArray data("BTDX", 4);
+  auto append = [&data](auto value) {
+    char bytes[sizeof(value)];
+    qToLittleEndian(value, bytes);
+    data.append(bytes, sizeof(value));
+  };
+
+  // version 1 header, the name table offset points right past it
+  append(quint32(1));
+  data.append("GNRL", 4);
+  append(static_cast<quint32>(files.size()));
+  append(quint64(24));
+
+  for (const QString& name : files) {
+    const QByteArray bytes = name.toLatin1();
+    append(static_cast<quint16>(bytes.size()));
+    data.append(bytes);
+  }
+
+  QDir().mkpath(QFileInfo(path).absolutePath());
+
+  QFile file(path);
+  if (file.open(QIODevice::WriteOnly)) {
+    file.write(data);
+  }
+}
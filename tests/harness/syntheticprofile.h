@@ -0,0 +1,90 @@
+/*
+Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+
+This file is part of basic diagnosis plugin for MO
+
+This plugin is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This plugin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SYNTHETICPROFILE_H
+#define SYNTHETICPROFILE_H
+
+#include "fakegame.h"
+#include "fakemodlist.h"
+#include "fakeorganizer.h"
+#include "fakepluginlist.h"
+
+#include <QStringList>
+#include <QTemporaryDir>
+
+#include <memory>
+
+// an instance of MO with a generated profile, laid out in a temporary directory
+// that is removed along with the profile
+//
+// every mod directory exists, plugins are spread over the mods and have real TES4
+// headers; each plugin requires the plugins right before it
+class SyntheticProfile
+{
+public:
+  struct Options
+  {
+    int mods    = 100;
+    int plugins = 500;
+
+    // masters of each plugin, taken from the plugins loading before it
+    int mastersPerPlugin = 2;
+
+    // plugins requiring a master that is not installed
+    int missingMasters = 0;
+
+    // files in the overwrite directory, spread over 16 directories that are nested
+    // overwriteDepth levels deep
+    int overwriteFiles = 0;
+    int overwriteDepth = 1;
+
+    // the files in the overwrite directory are log files, which the check ignores
+    // with ow_ignore_log, so it has to walk the whole tree
+    bool overwriteLogs = false;
+  };
+
+  explicit SyntheticProfile(const Options& options);
+
+  FakeOrganizer& organizer() { return *m_Organizer; }
+  FakeModList& modList() { return m_Mods; }
+  FakePluginList& pluginList() { return m_Plugins; }
+  FakeGame& game() { return *m_Game; }
+
+  // root of the instance, used as the data path of the application
+  QString basePath() const { return m_Root.path(); }
+
+  // writes a plugin file requiring the given masters
+  static void writePlugin(const QString& path, const QStringList& masters);
+
+  // writes a file of the given size, creating its directory
+  static void writeFile(const QString& path, qint64 size = 0);
+
+  // writes a general Fallout 4 archive listing the given files, their content is
+  // left out
+  static void writeArchive(const QString& path, const QStringList& files);
+
+private:
+  QTemporaryDir m_Root;
+  FakeModList m_Mods;
+  FakePluginList m_Plugins;
+  std::unique_ptr<FakeGame> m_Game;
+  std::unique_ptr<FakeOrganizer> m_Organizer;
+};
+
+#endif  // SYNTHETICPROFILE_H
@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "logscanner.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+void write(const QString& path, const QByteArray& data,
+           QIODevice::OpenMode mode = QIODevice::WriteOnly)
+{
+  QFile file(path);
+  ASSERT_TRUE(file.open(mode));
+  file.write(data);
+}
+
+void append(const QString& path, const QByteArray& data)
+{
+  write(path, data, QIODevice::WriteOnly | QIODevice::Append);
+}
+
+}  // namespace
+
+TEST(LogScannerTest, AggregatesEntriesAroundTheLastError)
+{
+  QTemporaryDir directory;
+  const QString path = directory.filePath("test.log");
+  write(path, "INFO start\n"
+              "ERROR (10:00) disk full\r\n"
+              "WARNING [10:01]: low memory\n"
+              "ERROR (10:02) disk full\n"
+              "INFO details\n");
+
+  LogScanner scanner;
+  ASSERT_TRUE(scanner.scan(path, 2, true));
+
+  ASSERT_EQ(scanner.entries().size(), 2);
+  EXPECT_TRUE(scanner.entries()[0].error);
+  EXPECT_EQ(scanner.entries()[0].message, "disk full");
+  EXPECT_EQ(scanner.entries()[0].count, 2);
+  EXPECT_EQ(scanner.entries()[0].firstTime, "10:00");
+  EXPECT_EQ(scanner.entries()[0].lastTime, "10:02");
+  EXPECT_FALSE(scanner.entries()[1].error);
+  EXPECT_EQ(scanner.entries()[1].message, "low memory");
+
+  EXPECT_EQ(scanner.context(),
+            (QStringList{"WARNING [10:01]: low memory", "ERROR (10:02) disk full",
+                         "INFO details"}));
+}
+
+TEST(LogScannerTest, IgnoresLogsWithoutErrors)
+{
+  QTemporaryDir directory;
+  const QString path = directory.filePath("test.log");
+  write(path, "INFO start\nWARNING low memory\n");
+
+  LogScanner scanner;
+  EXPECT_FALSE(scanner.scan(path, 2, true));
+  EXPECT_FALSE(scanner.scan(directory.filePath("missing.log"), 2, true));
+}
+
+TEST(LogScannerTest, ScansOnlyTheAppendedLines)
+{
+  QTemporaryDir directory;
+  const QString path = directory.filePath("test.log");
+  write(path, "ERROR a\n");
+
+  LogScanner scanner;
+  ASSERT_TRUE(scanner.scan(path, 1, false));
+
+  // the first line would be counted twice if it were scanned again
+  append(path, "ERROR a\nERROR b\n");
+  ASSERT_TRUE(scanner.scan(path, 1, false));
+  ASSERT_EQ(scanner.entries().size(), 2);
+  EXPECT_EQ(scanner.entries()[0].count, 2);
+  EXPECT_EQ(scanner.entries()[1].message, "b");
+  EXPECT_EQ(scanner.context(), QStringList{"ERROR b"});
+}
+
+TEST(LogScannerTest, RestartsOnTruncatedLogs)
+{
+  QTemporaryDir directory;
+  const QString path = directory.filePath("test.log");
+  write(path, "ERROR a\nERROR b\n");
+
+  LogScanner scanner;
+  ASSERT_TRUE(scanner.scan(path, 1, false));
+
+  write(path, "ERROR c\n");
+  ASSERT_TRUE(scanner.scan(path, 1, false));
+  ASSERT_EQ(scanner.entries().size(), 1);
+  EXPECT_EQ(scanner.entries()[0].message, "c");
+  EXPECT_EQ(scanner.entries()[0].count, 1);
+}
+
+TEST(LogScannerTest, RestartsWhenWarningsAreIncluded)
+{
+  QTemporaryDir directory;
+  const QString path = directory.filePath("test.log");
+  write(path, "WARNING w\nERROR a\n");
+
+  LogScanner scanner;
+  ASSERT_TRUE(scanner.scan(path, 1, false));
+  EXPECT_EQ(scanner.entries().size(), 1);
+
+  ASSERT_TRUE(scanner.scan(path, 1, true));
+  ASSERT_EQ(scanner.entries().size(), 2);
+  EXPECT_EQ(scanner.entries()[0].message, "w");
+  EXPECT_EQ(scanner.entries()[1].count, 1);
+}
+
+TEST(LogScannerTest, AggregatesTheLastLineOnceItIsComplete)
+{
+  QTemporaryDir directory;
+  const QString path = directory.filePath("test.log");
+  write(path, "INFO start\nERROR partial");
+
+  // the line may still be written to, it is only shown as context
+  LogScanner scanner;
+  ASSERT_TRUE(scanner.scan(path, 1, false));
+  EXPECT_TRUE(scanner.entries().empty());
+  EXPECT_EQ(scanner.context(), QStringList{"ERROR partial"});
+
+  append(path, " message\n");
+  ASSERT_TRUE(scanner.scan(path, 1, false));
+  ASSERT_EQ(scanner.entries().size(), 1);
+  EXPECT_EQ(scanner.entries()[0].message, "partial message");
+  EXPECT_EQ(scanner.entries()[0].count, 1);
+  EXPECT_EQ(scanner.context(), QStringList{"ERROR partial message"});
+}
+
+TEST(LogScannerTest, BoundsTheEntries)
+{
+  QTemporaryDir directory;
+  const QString path = directory.filePath("test.log");
+
+  QByteArray data = "ERROR " + QByteArray(1000, 'x') + "\n";
+  for (int i = 0; i < 250; ++i) {
+    data += "ERROR " + QByteArray::number(i) + "\n";
+  }
+  write(path, data);
+
+  LogScanner scanner;
+  ASSERT_TRUE(scanner.scan(path, 1, false));
+  EXPECT_EQ(scanner.entries().size(), 200);
+  EXPECT_EQ(scanner.unlisted(), 51);
+  EXPECT_EQ(scanner.entries()[0].message.size(), 500);
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "overwritewatcher.h"
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+void touch(const QString& path)
+{
+  QFile file(path);
+  ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+}
+
+// processes events until the condition holds or a few seconds have passed
+template <typename Condition>
+bool eventually(Condition condition)
+{
+  for (int i = 0; i < 250; ++i) {
+    if (condition()) {
+      return true;
+    }
+    QTest::qWait(20);
+  }
+  return condition();
+}
+
+}  // namespace
+
+TEST(OverwriteWatcherTest, FollowsTheContent)
+{
+  QTemporaryDir directory;
+  ASSERT_TRUE(QDir(directory.path()).mkpath("output/nested"));
+
+  OverwriteWatcher watcher(QRegularExpression(".*[.]log$"));
+  int changes = 0;
+  QObject::connect(&watcher, &OverwriteWatcher::changed, &watcher, [&changes]() {
+    ++changes;
+  });
+  watcher.watch(directory.path());
+  ASSERT_TRUE(eventually([&watcher]() {
+    return watcher.isTracking();
+  }));
+
+  // empty directories are only content when they are not ignored
+  EXPECT_EQ(watcher.hasContent({}, false, false), true);
+  EXPECT_EQ(watcher.hasContent({"Output"}, false, false), true);
+  EXPECT_EQ(watcher.hasContent({"other"}, false, false), false);
+  EXPECT_EQ(watcher.hasContent({}, true, false), false);
+
+  // log files are not content when they are ignored
+  touch(directory.filePath("output/nested/test.log"));
+  EXPECT_TRUE(eventually([&watcher]() {
+    return watcher.hasContent({}, true, false) == true;
+  }));
+  EXPECT_EQ(watcher.hasContent({}, true, true), false);
+
+  const int changesBefore = changes;
+  touch(directory.filePath("output/nested/test.esp"));
+  EXPECT_TRUE(eventually([&watcher]() {
+    return watcher.hasContent({}, true, true) == true;
+  }));
+  EXPECT_TRUE(eventually([&]() {
+    return changes > changesBefore;
+  }));
+
+  ASSERT_TRUE(QDir(directory.filePath("output")).removeRecursively());
+  EXPECT_TRUE(eventually([&watcher]() {
+    return watcher.hasContent({}, false, false) == false;
+  }));
+}
+
+TEST(OverwriteWatcherTest, IsNotTrackingOnceStopped)
+{
+  QTemporaryDir directory;
+
+  OverwriteWatcher watcher(QRegularExpression(".*[.]log$"));
+  watcher.watch(directory.path());
+  ASSERT_TRUE(eventually([&watcher]() {
+    return watcher.isTracking();
+  }));
+  EXPECT_EQ(watcher.hasContent({}, false, false), false);
+
+  watcher.stop();
+  EXPECT_TRUE(eventually([&watcher]() {
+    return !watcher.isTracking();
+  }));
+  EXPECT_FALSE(watcher.hasContent({}, false, false));
+}
+
+TEST(OverwriteWatcherTest, IsNotTrackingMissingDirectories)
+{
+  QTemporaryDir directory;
+
+  OverwriteWatcher watcher(QRegularExpression(".*[.]log$"));
+  watcher.watch(directory.filePath("missing"));
+  QTest::qWait(200);
+  EXPECT_FALSE(watcher.isTracking());
+  EXPECT_FALSE(watcher.hasContent({}, false, false));
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "plugingraph.h"
+#include "fakepluginlist.h"
+
+#include <gtest/gtest.h>
+
+using namespace MOBase;
+
+namespace
+{
+
+FakePluginList::Plugin plugin(const QString& name, const QStringList& masters = {})
+{
+  return FakePluginList::Plugin{name, "mod", masters, true, false};
+}
+
+}  // namespace
+
+TEST(PluginGraphTest, FindsMissingLateAndBrokenPlugins)
+{
+  FakePluginList plugins;
+  plugins.add(plugin("A.esm"));
+  plugins.add(plugin("B.esp", {"a.ESM"}));
+  plugins.add(plugin("C.esp", {"B.esp", "X.esm"}));
+  plugins.add(plugin("D.esp", {"C.esp"}));
+  plugins.add(plugin("E.esp", {"F.esp"}));
+  plugins.add(plugin("F.esp"));
+
+  PluginGraph graph;
+  EXPECT_FALSE(graph.isBuilt());
+  graph.rebuild(&plugins);
+  EXPECT_TRUE(graph.isBuilt());
+
+  const PluginGraph::Problems problems = graph.problems();
+  EXPECT_EQ(problems.missing.size(), 1);
+  EXPECT_EQ(problems.missing.at("X.esm"), std::set<QString>{"C.esp"});
+  EXPECT_EQ(problems.late.size(), 1);
+  EXPECT_EQ(problems.late.at("F.esp"), std::set<QString>{"E.esp"});
+  EXPECT_EQ(problems.broken.size(), 1);
+  EXPECT_EQ(problems.broken.at("D.esp"), "C.esp");
+}
+
+TEST(PluginGraphTest, FollowsStatesAndPriorities)
+{
+  FakePluginList plugins;
+  plugins.add(plugin("A.esm"));
+  plugins.add(plugin("B.esp", {"A.esm"}));
+
+  PluginGraph graph;
+  graph.rebuild(&plugins);
+  EXPECT_TRUE(graph.problems().empty());
+
+  graph.updateStates({{"a.esm", IPluginList::STATE_INACTIVE}});
+  EXPECT_EQ(graph.problems().missing.at("A.esm"), std::set<QString>{"B.esp"});
+
+  graph.updateStates({{"A.esm", IPluginList::STATE_ACTIVE}});
+  graph.updatePriority("A.esm", 0, 1);
+  EXPECT_EQ(graph.problems().late.at("A.esm"), std::set<QString>{"B.esp"});
+}
+
+TEST(PluginGraphTest, InactivePluginsAreNotReported)
+{
+  FakePluginList plugins;
+  FakePluginList::Plugin inactive = plugin("B.esp", {"Missing.esm"});
+  inactive.active                 = false;
+  plugins.add(inactive);
+
+  PluginGraph graph;
+  graph.rebuild(&plugins);
+  EXPECT_TRUE(graph.problems().empty());
+}
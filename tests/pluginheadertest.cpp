@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2013 Sebastian Herbord. All rights reserved.
+ *
+ * This file is part of the basic diagnosis plugin for Mod Organizer
+ *
+ * This plugin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This plugin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this plugin.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "pluginheader.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QtEndian>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+template <typename T>
+void append(QByteArray& data, T value)
+{
+  char bytes[sizeof(T)];
+  qToLittleEndian<T>(value, bytes);
+  data.append(bytes, sizeof(T));
+}
+
+void write(const QString& path, const QByteArray& data)
+{
+  QFile file(path);
+  ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+  file.write(data);
+}
+
+void subrecord(QByteArray& data, const char* type, const QByteArray& content)
+{
+  data.append(type, 4);
+  append<quint16>(data, content.size());
+  data.append(content);
+}
+
+// subrecords of a header listing the given masters
+QByteArray subrecords(const QList<QByteArray>& masters)
+{
+  QByteArray data;
+  subrecord(data, "HEDR", QByteArray(12, '\0'));
+  subrecord(data, "CNAM", QByteArray("author\0", 7));
+  for (const QByteArray& master : masters) {
+    subrecord(data, "MAST", master + '\0');
+    subrecord(data, "DATA", QByteArray(8, '\0'));
+  }
+  return data;
+}
+
+// header record holding the given subrecords, Oblivion has no version field at the
+// end of the record header
+QByteArray record(const QByteArray& subrecords, bool oblivion = false)
+{
+  QByteArray data("TES4", 4);
+  append<quint32>(data, subrecords.size());
+  append<quint32>(data, 0);
+  append<quint32>(data, 0);
+  append<quint32>(data, 0);
+  if (!oblivion) {
+    append<quint32>(data, 44);
+  }
+  return data + subrecords;
+}
+
+}  // namespace
+
+TEST(PluginHeaderTest, ReadsMasters)
+{
+  QTemporaryDir directory;
+  const QString path = directory.filePath("test.esp");
+  write(path, record(subrecords({"Skyrim.esm", "Update.esm"})) + "GRUP");
+
+  EXPECT_EQ(PluginHeader::readMasters(path), (QStringList{"Skyrim.esm", "Update.esm"}));
+}
+
+TEST(PluginHeaderTest, ReadsOblivionMasters)
+{
+  QTemporaryDir directory;
+  const QString path = directory.filePath("test.esp");
+  write(path, record(subrecords({"Oblivion.esm"}), true) + "GRUP");
+
+  EXPECT_EQ(PluginHeader::readMasters(path), QStringList{"Oblivion.esm"});
+}
+
+TEST(PluginHeaderTest, SkipsLargeSubrecords)
+{
+  QTemporaryDir directory;
+  const QString path = directory.filePath("test.esp");
+
+  // the size of the description does not fit in 16 bits and is given by an XXXX
+  // subrecord instead
+  QByteArray size;
+  append<quint32>(size, 70000);
+  QByteArray data = subrecords({"Skyrim.esm"});
+  subrecord(data, "XXXX", size);
+  subrecord(data, "SNAM", {});
+  data.append(QByteArray(70000, 'x'));
+  subrecord(data, "MAST", "Dawnguard.esm");
+  write(path, record(data));
+
+  EXPECT_EQ(PluginHeader::readMasters(path),
+            (QStringList{"Skyrim.esm", "Dawnguard.esm"}));
+}
+
+TEST(PluginHeaderTest, ReadsTheMastersOfTruncatedRecords)
+{
+  QTemporaryDir directory;
+  const QString path = directory.filePath("test.esp");
+  write(path, record(subrecords({"Skyrim.esm", "Update.esm"})).chopped(20));
+
+  EXPECT_EQ(PluginHeader::readMasters(path), QStringList{"Skyrim.esm"});
+}
+
+TEST(PluginHeaderTest, RejectsOtherFiles)
+{
+  QTemporaryDir directory;
+  const QString path = directory.filePath("test.esp");
+  write(path, QByteArray("TES3") + QByteArray(40, '\0'));
+
+  EXPECT_FALSE(PluginHeader::readMasters(path));
+  EXPECT_FALSE(PluginHeader::readMasters(directory.filePath("missing.esp")));
+}